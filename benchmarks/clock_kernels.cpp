@@ -0,0 +1,79 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/crdt/detail/clock_kernels.hpp"
+
+#include <chrono>
+#include <vector>
+#include <iostream>
+
+using namespace caf::crdt::detail;
+
+namespace {
+
+constexpr size_t iterations = 20000;
+constexpr size_t widths[] = {16, 256, 4096, 65536};
+
+template <class F>
+double measure(F f) {
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < iterations; ++i)
+    f();
+  auto stop = std::chrono::steady_clock::now();
+  std::chrono::duration<double, std::nano> elapsed = stop - start;
+  return elapsed.count() / iterations;
+}
+
+void run(const clock_kernels& kernels, size_t width) {
+  // Worst case for `dominance`: `rhs` dominates, no early exit possible
+  std::vector<uint64_t> lhs(width);
+  std::vector<uint64_t> rhs(width);
+  for (size_t i = 0; i < width; ++i) {
+    lhs[i] = i;
+    rhs[i] = i + (i % 2);
+  }
+  volatile size_t sink = 0;
+  auto dom = measure([&] {
+    bool greater = false;
+    bool smaller = false;
+    kernels.dominance(lhs.data(), rhs.data(), width, greater, smaller);
+    sink += greater ? 1 : 0;
+  });
+  auto dif = measure([&] {
+    sink += kernels.count_differ(lhs.data(), rhs.data(), width);
+  });
+  auto tmp = lhs;
+  auto jn = measure([&] {
+    kernels.join(tmp.data(), rhs.data(), width);
+  });
+  std::cout << kernels.name << " width=" << width
+            << " dominance=" << dom << "ns"
+            << " count_differ=" << dif << "ns"
+            << " join=" << jn << "ns" << std::endl;
+}
+
+} // namespace <anonymous>
+
+int main() {
+  for (auto width : widths) {
+    run(clock_kernels::scalar(), width);
+    if (&clock_kernels::instance() != &clock_kernels::scalar())
+      run(clock_kernels::instance(), width);
+  }
+}
@@ -0,0 +1,73 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/all.hpp"
+
+#include "caf/crdt/types/gcounter.hpp"
+
+#include <chrono>
+#include <vector>
+#include <iostream>
+
+using namespace caf;
+using namespace caf::crdt;
+using namespace caf::crdt::types;
+
+namespace {
+
+constexpr size_t iterations = 10000;
+constexpr size_t widths[] = {16, 256, 4096};
+
+template <class F>
+double measure(F f) {
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < iterations; ++i)
+    f();
+  auto stop = std::chrono::steady_clock::now();
+  std::chrono::duration<double, std::nano> elapsed = stop - start;
+  return elapsed.count() / iterations;
+}
+
+void caf_main(actor_system& system) {
+  auto dummy = [](event_based_actor*) {};
+  for (auto width : widths) {
+    gcounter<int> total{system.spawn(dummy)};
+    std::vector<gcounter<int>> contributors;
+    for (size_t i = 0; i < width; ++i) {
+      contributors.emplace_back(system.spawn(dummy));
+      contributors.back().increment();
+      total.merge(contributors.back());
+    }
+    volatile int sink = 0;
+    auto cnt = measure([&] { sink += total.count(); });
+    size_t next = 0;
+    auto delta = measure([&] {
+      // Merge a single-slot delta, the shape of published increments
+      auto& x = contributors[next++ % width];
+      x.increment();
+      sink += total.merge(x).count();
+    });
+    std::cout << "gcounter width=" << width << " count=" << cnt << "ns"
+              << " increment+merge=" << delta << "ns" << std::endl;
+  }
+}
+
+} // namespace <anonymous>
+
+CAF_MAIN()
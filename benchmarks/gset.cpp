@@ -0,0 +1,95 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/crdt/types/gset.hpp"
+#include "caf/crdt/types/gmap.hpp"
+
+#include <chrono>
+#include <iostream>
+
+using namespace caf::crdt;
+using namespace caf::crdt::types;
+
+namespace {
+
+constexpr size_t iterations = 20;
+constexpr int sizes[] = {1000, 100000};
+
+template <class F>
+double measure(F f) {
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < iterations; ++i)
+    f();
+  auto stop = std::chrono::steady_clock::now();
+  std::chrono::duration<double, std::micro> elapsed = stop - start;
+  return elapsed.count() / iterations;
+}
+
+/// Merges a full state into a replica which misses every tenth element,
+/// this is the shape of merges triggered by `tick_state_atom`.
+template <class Set>
+void run_set(const char* name, int size) {
+  std::set<int> all;
+  std::set<int> most;
+  for (int i = 0; i < size; ++i) {
+    all.insert(i);
+    if (i % 10 != 0)
+      most.insert(i);
+  }
+  Set full;
+  Set replica;
+  full.subset_insert(all);
+  replica.subset_insert(most);
+  volatile size_t sink = 0;
+  auto t = measure([&] {
+    auto tmp = replica;
+    sink += tmp.merge(full).size();
+  });
+  std::cout << name << " size=" << size << " copy+merge=" << t << "us"
+            << std::endl;
+}
+
+void run_map(int size) {
+  gmap<int, int> full;
+  gmap<int, int> replica;
+  for (int i = 0; i < size; ++i) {
+    full.set(i, 2);
+    if (i % 10 != 0)
+      replica.set(i, 1);
+  }
+  volatile size_t sink = 0;
+  auto t = measure([&] {
+    auto tmp = replica;
+    sink += tmp.merge(full).size();
+  });
+  std::cout << "gmap          size=" << size << " copy+merge=" << t << "us"
+            << std::endl;
+}
+
+} // namespace <anonymous>
+
+int main() {
+  for (auto size : sizes) {
+    run_set<gset<int, std::set<int>>>("gset<set>     ", size);
+    run_set<gset<int, detail::flat_set<int>>>("gset<flat_set>", size);
+    run_set<gset<int, detail::hash_set<int>>>("gset<hash_set>", size);
+    run_set<gset<int, detail::roaring_set<int>>>("gset<roaring> ", size);
+    run_map(size);
+  }
+}
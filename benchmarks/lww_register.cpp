@@ -0,0 +1,79 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/all.hpp"
+
+#include "caf/crdt/types/lww_register.hpp"
+
+#include <chrono>
+#include <vector>
+#include <iostream>
+
+using namespace caf;
+using namespace caf::crdt;
+using namespace caf::crdt::types;
+
+namespace {
+
+constexpr size_t iterations = 100000;
+
+template <class F>
+double measure(F f) {
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < iterations; ++i)
+    f();
+  auto stop = std::chrono::steady_clock::now();
+  std::chrono::duration<double, std::nano> elapsed = stop - start;
+  return elapsed.count() / iterations;
+}
+
+template <class Register>
+void run(const char* name, actor_system& system) {
+  auto dummy = [](event_based_actor*) {};
+  Register older{system.spawn(dummy)};
+  Register newer{system.spawn(dummy)};
+  older.set(1);
+  newer.merge(older);
+  newer.set(2);
+  // Every delta of a register is a full state, its size is the wire size
+  std::vector<char> buf;
+  binary_serializer sink{system, buf};
+  sink & newer;
+  volatile size_t res = 0;
+  auto adopt = measure([&] {
+    auto tmp = older;
+    res += tmp.merge(newer).empty();
+  });
+  auto reject = measure([&] {
+    auto tmp = newer;
+    res += tmp.merge(older).empty();
+  });
+  std::cout << name << " delta=" << buf.size() << "B"
+            << " copy+merge(newer)=" << adopt << "ns"
+            << " copy+merge(older)=" << reject << "ns" << std::endl;
+}
+
+void caf_main(actor_system& system) {
+  run<lww_register<int>>("vector_clock        ", system);
+  run<lww_register<int, hybrid_logical_clock>>("hybrid_logical_clock", system);
+}
+
+} // namespace <anonymous>
+
+CAF_MAIN()
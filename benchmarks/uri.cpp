@@ -0,0 +1,76 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/all.hpp"
+
+#include "caf/crdt/uri.hpp"
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <unordered_map>
+
+using namespace caf;
+using namespace caf::crdt;
+
+namespace {
+
+constexpr size_t iterations = 100000;
+
+template <class F>
+double measure(F f) {
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < iterations; ++i)
+    f(i);
+  auto stop = std::chrono::steady_clock::now();
+  std::chrono::duration<double, std::nano> elapsed = stop - start;
+  return elapsed.count() / iterations;
+}
+
+void caf_main(actor_system&) {
+  std::vector<std::string> strs;
+  for (size_t i = 0; i < 1024; ++i)
+    strs.emplace_back("gcounter<size_t>://views/videos/" + std::to_string(i));
+  std::vector<uri> uris{strs.begin(), strs.end()};
+  std::unordered_map<uri, size_t> map;
+  for (size_t i = 0; i < uris.size(); ++i)
+    map.emplace(uris[i], i);
+  volatile size_t res = 0;
+  auto parse = measure([&](size_t i) {
+    res += uri{strs[i % strs.size()]}.valid();
+  });
+  auto hash = measure([&](size_t i) {
+    res += std::hash<uri>{}(uris[i % uris.size()]);
+  });
+  auto lookup = measure([&](size_t i) {
+    res += map.find(uris[i % uris.size()])->second;
+  });
+  auto order = measure([&](size_t i) {
+    res += uris[i % uris.size()] < uris[(i + 1) % uris.size()];
+  });
+  std::cout << "parse=" << parse << "ns"
+            << " hash=" << hash << "ns"
+            << " lookup=" << lookup << "ns"
+            << " compare=" << order << "ns" << std::endl;
+}
+
+} // namespace <anonymous>
+
+CAF_MAIN()
@@ -0,0 +1,161 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/all.hpp"
+
+#include "caf/crdt/vector_clock.hpp"
+
+#include <chrono>
+#include <vector>
+#include <iostream>
+#include <unordered_map>
+
+using namespace caf;
+using namespace caf::crdt;
+
+namespace {
+
+constexpr size_t iterations = 2000;
+constexpr size_t widths[] = {16, 256, 4096};
+
+/// The map based clock used before slots got interned, kept as baseline.
+class map_clock {
+public:
+  using map_type = std::unordered_map<actor, uint64_t>;
+
+  void increment(const actor& slot) {
+    map_[slot]++;
+  }
+
+  vector_clock_result compare(const map_clock& other) const {
+    bool e = true;
+    bool g = true;
+    bool s = true;
+    for (auto& entry : map_) {
+      auto iter = other.map_.find(entry.first);
+      auto value = iter == other.map_.end() ? 0 : iter->second;
+      if (entry.second < value) {
+        e = false;
+        g = false;
+      }
+      if (entry.second > value) {
+        e = false;
+        s = false;
+      }
+    }
+    for (auto& entry : other.map_)
+      if (!map_.count(entry.first) && entry.second != 0) {
+        e = false;
+        g = false;
+      }
+    if (e) return equal;
+    if (g && !s) return greater;
+    if (!g && s) return smaller;
+    return concurrent;
+  }
+
+  map_type merge(const map_clock& other) {
+    map_type delta;
+    for (auto& entry : map_)
+      if (other.map_.count(entry.first) == 0)
+        delta.emplace(entry);
+    for (auto& entry : other.map_) {
+      auto iter = map_.find(entry.first);
+      if (iter == map_.end() || iter->second < entry.second)
+        delta.emplace(entry);
+    }
+    for (auto& entry : delta) {
+      auto& value = map_[entry.first];
+      value = std::max(value, entry.second);
+    }
+    return delta;
+  }
+
+private:
+  map_type map_;
+};
+
+template <class F>
+double measure(F f) {
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < iterations; ++i)
+    f();
+  auto stop = std::chrono::steady_clock::now();
+  std::chrono::duration<double, std::micro> elapsed = stop - start;
+  return elapsed.count() / iterations;
+}
+
+/// Fills `lhs` and `rhs` with `slots`, where `rhs` is ahead in every
+/// second slot. This is the shape of clocks merged by registers.
+template <class Clock>
+void fill(const std::vector<actor>& slots, Clock& lhs, Clock& rhs) {
+  for (size_t i = 0; i < slots.size(); ++i) {
+    lhs.increment(slots[i]);
+    rhs.increment(slots[i]);
+    if (i % 2 == 0)
+      rhs.increment(slots[i]);
+  }
+}
+
+template <class Clock>
+void run(const char* name, const std::vector<actor>& slots) {
+  Clock lhs;
+  Clock rhs;
+  fill(slots, lhs, rhs);
+  volatile size_t sink = 0;
+  auto cmp = measure([&] { sink += lhs.compare(rhs); });
+  auto mrg = measure([&] {
+    auto tmp = lhs;
+    sink += tmp.merge(rhs).size();
+  });
+  std::cout << name << " width=" << slots.size()
+            << " compare=" << cmp << "us"
+            << " copy+merge=" << mrg << "us" << std::endl;
+}
+
+/// Adapts `vector_clock` to the interface used by `run`.
+class flat_clock : public vector_clock {
+public:
+  void increment(const actor& slot) {
+    vector_clock::increment(slot);
+  }
+
+  struct delta_size {
+    size_t size() const { return n; }
+    size_t n;
+  };
+
+  delta_size merge(const flat_clock& other) {
+    return {vector_clock::merge(other).count()};
+  }
+};
+
+void caf_main(actor_system& system) {
+  for (auto width : widths) {
+    std::vector<actor> slots;
+    for (size_t i = 0; i < width; ++i)
+      slots.emplace_back(system.spawn([](event_based_actor*) {}));
+    run<map_clock>("unordered_map", slots);
+    run<flat_clock>("vector_clock ", slots);
+  }
+}
+
+} // namespace <anonymous>
+
+CAF_MAIN()
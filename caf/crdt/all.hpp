@@ -25,6 +25,8 @@
 #include "caf/crdt/notifiable.hpp"
 #include "caf/crdt/replicator.hpp"
 #include "caf/crdt/crdt_config.hpp"
+#include "caf/crdt/flush_metrics.hpp"
+#include "caf/crdt/notify_metrics.hpp"
 
 #include "caf/crdt/types/all.hpp"
 
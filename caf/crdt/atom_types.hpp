@@ -102,9 +102,69 @@ using connection_lost_atom = atom_constant<atom("conLost")>;
 /// @private
 using get_ids_atom = atom_constant<atom("getIds")>;
 
+/// @private
+using ids_delta_atom = atom_constant<atom("idsDelta")>;
+
+/// @private
+using retire_node_atom = atom_constant<atom("retireNode")>;
+
+/// @private
+using mark_atom = atom_constant<atom("mark")>;
+
+/// @private
+using covered_atom = atom_constant<atom("covered")>;
+
 /// @private
 using timeout_atom = atom_constant<atom("timeout")>;
 
+/// @private
+using forward_atom = atom_constant<atom("forward")>;
+
+/// @private
+using routes_atom = atom_constant<atom("routes")>;
+
+/// @private
+using add_id_atom = atom_constant<atom("addId")>;
+
+/// @private
+using batch_atom = atom_constant<atom("batch")>;
+
+/// @private
+using flush_timer_atom = atom_constant<atom("flushTimer")>;
+
+/// @private
+using delta_ack_atom = atom_constant<atom("deltaAck")>;
+
+/// @private
+using unknown_id_atom = atom_constant<atom("unknownId")>;
+
+/// @private
+using reannounce_atom = atom_constant<atom("reannounce")>;
+
+/// @private
+using digest_atom = atom_constant<atom("digest")>;
+
+/// @private
+using reconcile_atom = atom_constant<atom("reconcile")>;
+
+/// @private
+using gossip_atom = atom_constant<atom("gossip")>;
+
+/// @private
+using zone_atom = atom_constant<atom("zone")>;
+
+/// @private
+using wheel_atom = atom_constant<atom("wheel")>;
+
+/// @private
+using wheel_tick_atom = atom_constant<atom("wheelTick")>;
+
+/// @private
+using handoff_atom = atom_constant<atom("handoff")>;
+
+/// @private
+using handoff_ack_atom = atom_constant<atom("handoffAck")>;
+
 } // namespace crdt
 } // namespace caf
 
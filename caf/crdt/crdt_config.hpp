@@ -26,6 +26,10 @@
 #include "caf/io/middleman.hpp"
 
 #include "caf/crdt/detail/replica.hpp"
+#include "caf/crdt/detail/delta_join.hpp"
+
+#include <string>
+#include <stdexcept>
 
 namespace caf {
 namespace crdt {
@@ -43,12 +47,14 @@ public:
   template <class Type>
   actor_system_config& add_crdt(const std::string& name) {
     add_message_type<Type>(name);
-    add_actor_type<crdt::detail::replica<Type>,
-                   const uri&, const size_t&>(name);
+    add_actor_type<crdt::detail::replica<Type>, const uri&, const size_t&,
+                   const size_t&, const size_t&>(name);
+    crdt_delta_joins.emplace(name, &crdt::detail::join_deltas<Type>);
     return *this;
   }
 
-  /// Set the buffer flush interval (Default: 2 Seconds)
+  /// Set the buffer flush interval, i.e., the max time a delta stays in the
+  /// buffer before it is shipped (Default: 2 Seconds)
   /// @param interval in milliseconds or higher resolution (std::chrono)
   template <class Interval>
   actor_system_config& set_flush_interval(Interval interval) {
@@ -58,6 +64,25 @@ public:
     return *this;
   }
 
+  /// Set the number of buffered deltas which flushes the buffer immediately
+  /// (Default: 4096, 0 disables this trigger)
+  /// @param n number of deltas
+  actor_system_config& set_flush_max_deltas(size_t n) {
+    crdt_flush_max_deltas = n;
+    return *this;
+  }
+
+  /// Set the idle interval, the buffer is flushed once no delta has been
+  /// buffered for this long (Default: 0, disabled)
+  /// @param interval in milliseconds or higher resolution (std::chrono)
+  template <class Interval>
+  actor_system_config& set_flush_idle_interval(Interval interval) {
+    using std::chrono::milliseconds;
+    using std::chrono::duration_cast;
+    crdt_flush_idle_ms = duration_cast<milliseconds>(interval).count();
+    return *this;
+  }
+
   /// Set the notify interval (Default: 500ms)
   /// @param interval in milliseconds or higher resolution (std::chrono)
   template <class Interval>
@@ -68,8 +93,25 @@ public:
     return *this;
   }
 
-  /// Set the state interval. The complete state will be shipped
-  /// in this interval. (Default: 2 Minutes)
+  /// Let each replica adapt its notify interval within `[min, max]`
+  /// (Default: disabled, i.e., all replicas use the notify interval).
+  /// Rarely updated replicas notify after `min`, replicas with many deltas
+  /// and subscribers or a long mailbox coalesce deltas for up to `max`.
+  /// The replicator reports the chosen intervals.
+  /// @param min lower bound in milliseconds or higher resolution
+  /// @param max upper bound in milliseconds or higher resolution
+  template <class Interval>
+  actor_system_config& set_notify_interval_bounds(Interval min, Interval max) {
+    using std::chrono::milliseconds;
+    using std::chrono::duration_cast;
+    crdt_notify_min_ms = duration_cast<milliseconds>(min).count();
+    crdt_notify_max_ms = duration_cast<milliseconds>(max).count();
+    return *this;
+  }
+
+  /// Set the state interval. Replicas reconcile their digests with the
+  /// replicas of other nodes and transfer differing parts only in this
+  /// interval. (Default: 2 Minutes)
   /// @param interval in milliseconds or higher resolution (std::chrono)
   template <class Interval>
   actor_system_config& set_state_interval(Interval interval) {
@@ -79,8 +121,9 @@ public:
     return *this;
   }
 
-  /// Set the interval id refresh interval. This node will ask other nodes
-  /// for changed replic ids in the specified interval. (Default: 1 Secound)
+  /// Set the interval id refresh interval. This node will push the changes
+  /// of its replic ids to other nodes in the specified interval, nothing is
+  /// sent if no id has changed. (Default: 1 Secound)
   /// @param interval in milliseconds or higher resolution (std::chrono)
   template <class Interval>
   actor_system_config& set_refresh_ids_interval(Interval interval) {
@@ -89,6 +132,123 @@ public:
     crdt_ids_interval_ms = duration_cast<milliseconds>(interval).count();
     return *this;
   }
+
+  /// Set the number of flushed delta groups retained for unacknowledged
+  /// nodes (Default: 64). A node which reconnects after more flushes
+  /// receives the full states of its replicas instead.
+  /// @param n number of retained groups
+  actor_system_config& set_delta_log_size(size_t n) {
+    crdt_delta_log_size = n;
+    return *this;
+  }
+
+  /// Disseminate deltas epidemically (Default: 0, i.e., disabled). Each
+  /// node pushes a delta to `fanout` random intrested nodes instead of all
+  /// of them and reconciles with `fanout` random nodes per round. Gossip
+  /// requires a single replicator shard.
+  /// @param fanout number of nodes per push and pull
+  /// @throws std::invalid_argument if more than one shard is set
+  actor_system_config& set_gossip_fanout(size_t fanout) {
+    crdt_gossip_fanout = fanout;
+    return check_shards();
+  }
+
+  /// Set the zone of this node, e.g., its rack or data center (Default: none,
+  /// i.e., a flat mesh). Deltas of a uri cross to another zone once, at the
+  /// relay of the uri in that zone, which passes them on to the intrested
+  /// nodes of its zone. Relayed deltas are acknowledged like direct ones.
+  /// Gossip takes precedence over zones, which require a single replicator
+  /// shard.
+  /// @param label name of the zone
+  /// @throws std::invalid_argument if more than one shard is set
+  actor_system_config& set_zone(std::string label) {
+    crdt_zone = std::move(label);
+    return check_shards();
+  }
+
+  /// Replicate each uri on `r` nodes only (Default: 0, i.e., on all
+  /// intrested nodes). Uris are placed on a consistent hash ring with `vnodes`
+  /// points per node, other nodes forward reads and writes to an owner.
+  /// Placement requires a single replicator shard.
+  /// @param r      replication factor
+  /// @param vnodes virtual nodes per node
+  /// @throws std::invalid_argument if more than one shard is set
+  actor_system_config& set_replication_factor(size_t r, size_t vnodes = 64) {
+    crdt_replication_factor = r;
+    crdt_virtual_nodes = vnodes;
+    return check_shards();
+  }
+
+  /// Set the number of replicator shards (Default: 1). With more than one
+  /// shard, the replicator partitions its replicas by uri hash across this
+  /// many actors, each owning its replicas and its buffer of deltas. Rumors,
+  /// relayed deltas and hand-offs pass the replicator itself, hence more
+  /// than one shard cannot be combined with gossip, zones or placement.
+  /// @param n number of shards
+  /// @throws std::invalid_argument if combined with gossip, zones or placement
+  actor_system_config& set_replicator_shards(size_t n) {
+    crdt_replicator_shards = n;
+    return check_shards();
+  }
+
+  /// @returns why the replicator shards cannot be combined with the other
+  ///          settings, an empty string if they can
+  std::string shards_conflict() const {
+    if (crdt_replicator_shards <= 1)
+      return {};
+    if (crdt_gossip_fanout > 0)
+      return "crdt_config: gossip requires a single replicator shard";
+    if (!crdt_zone.empty())
+      return "crdt_config: zones require a single replicator shard";
+    if (crdt_replication_factor > 0)
+      return "crdt_config: placement requires a single replicator shard";
+    return {};
+  }
+
+  /// Joins of all added crdt types, the replicator uses them to coalesce
+  /// buffered deltas of a replica before shipping them
+  crdt::detail::delta_join_map crdt_delta_joins;
+
+  /// Number of replicator shards, more than one cannot be combined with
+  /// gossip, zones or placement
+  size_t crdt_replicator_shards = 1;
+
+  /// Buffered deltas which trigger a flush
+  size_t crdt_flush_max_deltas = 4096;
+
+  /// Idle interval which triggers a flush in milliseconds
+  size_t crdt_flush_idle_ms = 0;
+
+  /// Flushed delta groups retained for unacknowledged nodes
+  size_t crdt_delta_log_size = 64;
+
+  /// Fanout of the gossip mode, 0 disables gossip
+  size_t crdt_gossip_fanout = 0;
+
+  /// Owners of each uri, 0 replicates uris on all intrested nodes
+  size_t crdt_replication_factor = 0;
+
+  /// Points of each node on the hash ring
+  size_t crdt_virtual_nodes = 64;
+
+  /// Zone of this node, empty for a flat mesh
+  std::string crdt_zone;
+
+  /// Lower bound of adaptive notify intervals in milliseconds
+  size_t crdt_notify_min_ms = 0;
+
+  /// Upper bound of adaptive notify intervals in milliseconds, 0 disables
+  /// adaptive intervals
+  size_t crdt_notify_max_ms = 0;
+
+private:
+  /// @throws std::invalid_argument if `shards_conflict` reports a conflict
+  actor_system_config& check_shards() {
+    auto conflict = shards_conflict();
+    if (!conflict.empty())
+      throw std::invalid_argument(conflict);
+    return *this;
+  }
 };
 
 } // namespace crdt
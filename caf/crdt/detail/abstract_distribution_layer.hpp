@@ -23,6 +23,14 @@
 #include "caf/fwd.hpp"
 
 #include "caf/crdt/uri.hpp"
+#include "caf/crdt/replicator_actor.hpp"
+
+#include "caf/crdt/detail/anti_entropy.hpp"
+
+#include <set>
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace caf {
 namespace crdt {
@@ -31,6 +39,13 @@ namespace detail {
 /// Manages the data send between nodes.
 class abstract_distribution_layer {
 public:
+  /// Local replicas by uri
+  using state_map = std::unordered_map<uri, actor>;
+
+  virtual ~abstract_distribution_layer() {
+    // nop
+  }
+
   /// Add a freshly discovered node
   /// @param nid node to add
   virtual void add_new_node(const node_id& nid) = 0;
@@ -39,6 +54,10 @@ public:
   /// @param nid node to remove
   virtual void remove_node(const node_id& nid) = 0;
 
+  /// A lost node has been retired and will not reconnect
+  /// @param nid retired node
+  virtual void retire_node(const node_id& nid) = 0;
+
   /// Update a map entry
   /// @param nid      regarding node
   /// @param version  version of set
@@ -46,6 +65,24 @@ public:
   virtual void update(const node_id& nid, size_t version,
                       std::unordered_set<uri>&& ids) = 0;
 
+  /// Apply changes of the ids of a node
+  /// @param nid      regarding node
+  /// @param base     version the changes are based on
+  /// @param version  version of set after the changes
+  /// @param added    added ids
+  /// @param removed  removed ids
+  virtual void update(const node_id& nid, size_t base, size_t version,
+                      const std::unordered_set<uri>& added,
+                      const std::unordered_set<uri>& removed) = 0;
+
+  /// Push the changes of local ids to all nodes
+  virtual void push_ids() = 0;
+
+  /// A node has asked for our ids
+  /// @param nid node intrested in our ids
+  /// @param seen last version seen by `nid`
+  virtual void get_ids(const node_id& nid, size_t seen) = 0;
+
   /// Locally add a replic Id, this is called, when a new replica<T> is spawned
   /// @param u uri to add
   virtual void add_id(const uri& u) = 0;
@@ -62,6 +99,46 @@ public:
   /// Flushes the update buffer
   virtual void flush_buffer() = 0;
 
+  /// The intrested nodes have changed, ship what they are missing
+  /// @param states local replicas
+  virtual void sync(const state_map& states) = 0;
+
+  /// A node has acknowledged all batches up to `seq`
+  /// @param nid acknowledging node
+  /// @param seq sequence number of the batch
+  /// @param states local replicas
+  virtual void ack(const node_id& nid, uint64_t seq,
+                   const state_map& states) = 0;
+
+  /// A local replica has sent its full state
+  /// @param id of the replica
+  /// @param msg containing the state
+  virtual void state(const uri& id, message msg) = 0;
+
+  /// A local replica was deleted
+  /// @param id of the replica
+  virtual void drop_state(const uri& id) = 0;
+
+  /// Ships the full states of all local replicas to all peers again
+  /// @param states local replicas
+  /// @returns `false` if this layer cannot tell which peers received them
+  virtual bool mark(const state_map& states) = 0;
+
+  /// @returns `true` if `nid` has acknowledged the full states of all local
+  ///          replicas since the last `mark`
+  virtual bool marked(const node_id& nid) const = 0;
+
+  /// Announces all ids to `nid` again and resends what it has not
+  /// acknowledged, `nid` dropped a batch with an unknown id
+  /// @param states local replicas
+  virtual void resync(const node_id& nid, const state_map& states) = 0;
+
+  /// @returns the replicators to reconcile each uri with
+  virtual route_map routes() const = 0;
+
+  /// @returns the replicator of `nid`, an invalid handle if `nid` is unknown
+  virtual replicator_actor replicator_of(const node_id& nid) const = 0;
+
   /// Get intrested nodes to a id
   /// @param id replic id
   /// @returns set of replicator_actors
@@ -0,0 +1,135 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_CRDT_DETAIL_ADAPTIVE_FLUSH_HPP
+#define CAF_CRDT_DETAIL_ADAPTIVE_FLUSH_HPP
+
+#include "caf/crdt/atom_types.hpp"
+#include "caf/crdt/flush_metrics.hpp"
+
+#include <chrono>
+#include <memory>
+#include <algorithm>
+
+namespace caf {
+namespace crdt {
+namespace detail {
+
+/// Decides when an actor flushes its delta buffer. A flush fires once the
+/// number of buffered deltas crosses a threshold, once the oldest buffered
+/// delta has waited for the max delay or once no delta has been buffered
+/// for the idle interval. The timer only runs while the buffer is not
+/// empty, an idle actor does not wake up.
+class adaptive_flush {
+public:
+  using clock_type = std::chrono::steady_clock;
+  using duration = std::chrono::milliseconds;
+
+  /// @param max_deltas size threshold, `0` disables it
+  /// @param max_delay max time a delta stays in the buffer
+  /// @param idle idle interval, `0` disables it
+  /// @param metrics records which trigger fired, may be `nullptr`
+  adaptive_flush(size_t max_deltas, duration max_delay, duration idle,
+                 std::shared_ptr<flush_metrics> metrics)
+    : max_deltas_{max_deltas}, max_delay_{max_delay}, idle_{idle},
+      metrics_{std::move(metrics)} {
+    // nop
+  }
+
+  /// Records `n` deltas buffered by `self`, then flushes the buffer via
+  /// `flush` if it is full or arms the timer if it was empty
+  template <class Self, class Flush>
+  void buffered(Self* self, Flush flush, size_t n = 1) {
+    auto now = clock_type::now();
+    if (pending_ == 0)
+      first_ = now;
+    last_ = now;
+    pending_ += n;
+    if (max_deltas_ > 0 && pending_ >= max_deltas_) {
+      fire(flush_trigger::size, flush);
+      return;
+    }
+    if (!timer_) {
+      auto wait = idle_.count() > 0 ? std::min(idle_, max_delay_)
+                                    : max_delay_;
+      arm(self, wait);
+    }
+  }
+
+  /// Handles the timer of `self`, i.e., a `flush_timer_atom`
+  template <class Self, class Flush>
+  void timeout(Self* self, Flush flush) {
+    timer_ = false;
+    if (pending_ == 0)
+      return;
+    auto now = clock_type::now();
+    auto deadline = first_ + max_delay_;
+    if (now >= deadline) {
+      fire(flush_trigger::delay, flush);
+      return;
+    }
+    auto wait = deadline - now;
+    if (idle_.count() > 0) {
+      auto idle_deadline = last_ + idle_;
+      if (now >= idle_deadline) {
+        fire(flush_trigger::idle, flush);
+        return;
+      }
+      wait = std::min(wait, idle_deadline - now);
+    }
+    // Round up, waking up early only reschedules the timer
+    arm(self, std::chrono::duration_cast<duration>(wait) + duration{1});
+  }
+
+  /// Flushes the buffer regardless of any trigger
+  template <class Flush>
+  void force(Flush flush) {
+    fire(flush_trigger::forced, flush);
+  }
+
+private:
+  template <class Flush>
+  void fire(flush_trigger x, Flush& flush) {
+    flush();
+    if (metrics_ && pending_ > 0)
+      metrics_->record(x, pending_);
+    pending_ = 0;
+  }
+
+  template <class Self>
+  void arm(Self* self, duration wait) {
+    timer_ = true;
+    self->delayed_send(self, wait, flush_timer_atom::value);
+  }
+
+  size_t max_deltas_;                      /// Size threshold
+  duration max_delay_;                     /// Max time in buffer
+  duration idle_;                          /// Idle interval
+  std::shared_ptr<flush_metrics> metrics_; /// Flushes per trigger
+  size_t pending_ = 0;                     /// Buffered deltas
+  clock_type::time_point first_;           /// Oldest buffered delta
+  clock_type::time_point last_;            /// Latest buffered delta
+  bool timer_ = false;                     /// Timer is armed
+};
+
+} // namespace detail
+} // namespace crdt
+} // namespace caf
+
+#endif // CAF_CRDT_DETAIL_ADAPTIVE_FLUSH_HPP
@@ -0,0 +1,121 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+
+#ifndef CAF_CRDT_DETAIL_ADAPTIVE_NOTIFY_HPP
+#define CAF_CRDT_DETAIL_ADAPTIVE_NOTIFY_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <algorithm>
+
+namespace caf {
+namespace crdt {
+namespace detail {
+
+/// Chooses the notify interval of a replica within `[min, max]`. The load
+/// of a replica is the rate of merged deltas times the number of its
+/// subscribers, i.e., the notifications per second it would send at the
+/// min interval. Replicas below one notification per min interval notify
+/// after the min interval, loaded replicas coalesce deltas for a longer
+/// window, which grows with their load and with the backlog of their own
+/// mailbox. The rate is an exponential moving average over notifications.
+class adaptive_notify {
+public:
+  using clock_type = std::chrono::steady_clock;
+  using duration = std::chrono::milliseconds;
+
+  /// Mailbox backlog which doubles the interval
+  static constexpr size_t backlog_scale = 64;
+
+  /// @param initial interval until the first notification
+  /// @param min lower bound of the interval
+  /// @param max upper bound of the interval, `0` keeps `initial`
+  adaptive_notify(duration initial, duration min, duration max)
+    : min_{std::min(min, max)}, max_{max}, interval_{initial},
+      last_{clock_type::now()} {
+    if (enabled())
+      interval_ = std::max(min_, std::min(interval_, max_));
+  }
+
+  /// Records `n` deltas merged into the buffer
+  inline void merged(size_t n = 1) {
+    deltas_ += n;
+  }
+
+  /// Updates the interval at a notification
+  /// @param subscribers number of subscribers of the replica
+  /// @param backlog messages waiting in the mailbox of the replica
+  /// @returns `true` if the interval has changed
+  bool notified(size_t subscribers, size_t backlog) {
+    auto now = clock_type::now();
+    auto elapsed = std::chrono::duration<double>(now - last_).count();
+    last_ = now;
+    if (elapsed > 0) {
+      auto rate = deltas_ / elapsed;
+      rate_ = rate_ < 0 ? rate : rate_ + (rate - rate_) / 4;
+    }
+    deltas_ = 0;
+    if (!enabled())
+      return false;
+    auto before = interval_;
+    if (subscribers == 0) {
+      // Notifications only empty the buffer
+      interval_ = max_;
+      return interval_ != before;
+    }
+    auto min_s = std::chrono::duration<double>(min_).count();
+    auto load = std::max(1.0, rate_ * min_s * subscribers);
+    load *= 1.0 + static_cast<double>(backlog) / backlog_scale;
+    auto ms = static_cast<double>(min_.count()) * load;
+    interval_ = ms < static_cast<double>(max_.count())
+                ? std::max(min_, duration{static_cast<duration::rep>(ms)})
+                : max_;
+    return interval_ != before;
+  }
+
+  /// @returns the current interval
+  inline duration interval() const {
+    return interval_;
+  }
+
+  /// @returns the merged deltas per second
+  inline double rate() const {
+    return std::max(rate_, 0.0);
+  }
+
+  /// @returns `true` if the interval adapts, `false` if it is fixed
+  inline bool enabled() const {
+    return max_.count() > 0;
+  }
+
+private:
+  duration min_;                 /// Lower bound
+  duration max_;                 /// Upper bound
+  duration interval_;            /// Current interval
+  clock_type::time_point last_;  /// Last notification
+  size_t deltas_ = 0;            /// Merged deltas since `last_`
+  double rate_ = -1;             /// Merged deltas per second, < 0 if unknown
+};
+
+} // namespace detail
+} // namespace crdt
+} // namespace caf
+
+#endif // CAF_CRDT_DETAIL_ADAPTIVE_NOTIFY_HPP
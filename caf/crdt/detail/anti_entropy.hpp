@@ -0,0 +1,444 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_CRDT_DETAIL_ANTI_ENTROPY_HPP
+#define CAF_CRDT_DETAIL_ANTI_ENTROPY_HPP
+
+#include "caf/send.hpp"
+#include "caf/node_id.hpp"
+
+#include "caf/crdt/uri.hpp"
+#include "caf/crdt/atom_types.hpp"
+#include "caf/crdt/replicator_actor.hpp"
+
+#include "caf/crdt/detail/delta_join.hpp"
+#include "caf/crdt/detail/uri_registry.hpp"
+
+#include <deque>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace caf {
+namespace crdt {
+namespace detail {
+
+/// Maps uris to the replicators of all intrested nodes
+using route_map = std::unordered_map<uri, std::vector<replicator_actor>>;
+
+/// Delta-interval anti-entropy after Almeida et al. Each flush joins the
+/// buffered deltas into a numbered group, which is retained in a log until
+/// all peers acknowledged it. A reconnecting peer receives its unacknowledged
+/// groups again if the log still has them. Only connected peers hold back
+/// groups, peers which fell behind the log, and peers which start to
+/// replicate a uri, receive the full state of the local replica instead.
+/// Acknowledgements rely on the ordered delivery per connection of CAF.
+/// Buffer and log key deltas by interned uri, batches carry these ids and
+/// announce the uri of an id once per peer and connection, and again once the
+/// peer drops a batch with an id it does not know. Deltas passed on
+/// for another node, e.g., by the relay of a zone, only go to the peers of
+/// the pass routes. A mark ships all full states again, e.g., once a node
+/// was lost, and tells which peers acknowledged them.
+class anti_entropy {
+  /// @private
+  using uri_id = uri_registry::uri_id;
+
+public:
+  /// Local replicas by uri
+  using state_map = std::unordered_map<uri, actor>;
+
+  /// @param self sends all messages on behalf of this actor
+  /// @param joins coalesce buffered deltas per uri scheme
+  /// @param max_groups number of groups retained at most
+  anti_entropy(actor self, delta_join_map joins, size_t max_groups)
+      : self_{std::move(self)}, joins_{std::move(joins)},
+        max_groups_{std::max(max_groups, size_t{1})} {
+    // nop
+  }
+
+  /// Adds a delta of `id` to the buffer
+  void publish(const uri& id, message msg) {
+    buffer(id).deltas.emplace_back(std::move(msg));
+  }
+
+  /// Adds a delta of `id` received from another node to the buffer, it is
+  /// shipped to the peers of the pass routes only
+  void pass_on(const uri& id, message msg) {
+    buffer(id).passed.emplace_back(std::move(msg));
+  }
+
+  /// Joins the buffer into a new group and ships it to all intrested peers
+  void flush() {
+    wire_batch group;
+    std::unordered_map<node_id, wire_batch> batches;
+    for (auto& entry : buffer_) {
+      auto& x = entry.second;
+      join_buffered(joins_, x.scheme, x.deltas);
+      join_buffered(joins_, x.scheme, x.passed);
+      std::unordered_set<node_id> done;
+      auto i = id_pass_routes_.find(entry.first);
+      if (!x.passed.empty() && i != id_pass_routes_.end())
+        for (auto& hdl : i->second) {
+          auto xs = x.deltas;
+          xs.insert(xs.end(), x.passed.begin(), x.passed.end());
+          batches[hdl.node()].emplace_back(entry.first, std::move(xs));
+          done.emplace(hdl.node());
+        }
+      auto j = id_routes_.find(entry.first);
+      if (!x.deltas.empty() && j != id_routes_.end())
+        for (auto& hdl : j->second)
+          if (done.count(hdl.node()) == 0)
+            batches[hdl.node()].emplace_back(entry.first, x.deltas);
+      // Resends may carry passed on deltas to any peer, which merges them
+      // like duplicates
+      x.deltas.insert(x.deltas.end(), x.passed.begin(), x.passed.end());
+      if (!x.deltas.empty())
+        group.emplace_back(entry.first, std::move(x.deltas));
+    }
+    buffer_.clear();
+    if (group.empty())
+      return;
+    auto seq = ++seq_;
+    for (auto& kvp : peers_) {
+      auto& p = kvp.second;
+      if (!p.hdl)
+        continue;
+      auto iter = batches.find(kvp.first);
+      if (iter != batches.end()) {
+        ship(p, seq, std::move(iter->second));
+        p.sent = seq;
+      } else if (!p.in_flight && p.sent == p.acked) {
+        // Nothing to ship and nothing in flight, the peer is up to date
+        p.sent = p.acked = seq;
+      }
+    }
+    log_.emplace_back(seq, std::move(group));
+    gc();
+  }
+
+  /// Adopts the intrested peers per uri. Peers without routes count as
+  /// disconnected, new or reconnected peers receive what they are missing.
+  /// @param pass_routes peers per uri receiving passed on deltas, which
+  ///                    must be routes as well
+  void update(route_map routes, const state_map& states,
+              const route_map& pass_routes = {}) {
+    routes_ = std::move(routes);
+    id_routes_.clear();
+    id_pass_routes_.clear();
+    auto& reg = uri_registry::instance();
+    for (auto& entry : routes_)
+      id_routes_.emplace(reg.intern(entry.first), entry.second);
+    for (auto& entry : pass_routes)
+      id_pass_routes_.emplace(reg.intern(entry.first), entry.second);
+    std::unordered_map<node_id, std::pair<replicator_actor,
+                                          std::unordered_set<uri>>> wanted;
+    for (auto& entry : routes_) {
+      for (auto& hdl : entry.second) {
+        auto& x = wanted[hdl.node()];
+        x.first = hdl;
+        x.second.emplace(entry.first);
+      }
+    }
+    for (auto& kvp : peers_) {
+      auto iter = wanted.find(kvp.first);
+      if (kvp.second.hdl
+          && (iter == wanted.end() || iter->second.first != kvp.second.hdl))
+        disconnect(kvp.second);
+    }
+    for (auto& kvp : wanted) {
+      auto& p = peers_[kvp.first];
+      p.wanted = std::move(kvp.second.second);
+      if (!p.hdl) {
+        p.hdl = std::move(kvp.second.first);
+        connect(p);
+      }
+      request(kvp.first, p, states);
+    }
+  }
+
+  /// Handles the acknowledgement of `seq` by `peer`
+  void ack(const node_id& peer, uint64_t seq, const state_map& states) {
+    auto iter = peers_.find(peer);
+    if (iter == peers_.end())
+      return;
+    auto& p = iter->second;
+    if (p.in_flight) {
+      // Groups acknowledged before the state do not cover its uris
+      if (seq != p.state_seq || !p.pending.empty())
+        return;
+      p.in_flight = false;
+      // States collected before a mark may miss deltas merged since
+      if (!p.remark)
+        for (auto& id : p.shipped)
+          p.known.emplace(id);
+      p.remark = false;
+      p.shipped.clear();
+      p.acked = std::max(p.acked, seq);
+      request(peer, p, states);
+    } else {
+      p.acked = std::max(p.acked, seq);
+    }
+    gc();
+  }
+
+  /// Handles the full state of the local replica of `id`
+  void state(const uri& id, message msg) {
+    auto iter = requests_.find(id);
+    if (iter == requests_.end())
+      return;
+    for (auto& node : iter->second) {
+      auto i = peers_.find(node);
+      if (i == peers_.end() || i->second.pending.erase(id) == 0)
+        continue;
+      i->second.states[id].emplace_back(msg);
+      if (i->second.pending.empty())
+        ship_states(i->second);
+    }
+    requests_.erase(iter);
+  }
+
+  /// Ships the full states of all local replicas to all peers again
+  void mark(const state_map& states) {
+    for (auto& kvp : peers_) {
+      auto& p = kvp.second;
+      p.marked = false;
+      p.known.clear();
+      if (p.in_flight)
+        p.remark = true;
+      else
+        request(kvp.first, p, states);
+    }
+  }
+
+  /// @returns `true` if `node` is connected and has acknowledged the full
+  ///          states of all local replicas it replicates since the last mark
+  bool marked(const node_id& node) const {
+    auto iter = peers_.find(node);
+    return iter != peers_.end() && iter->second.hdl && iter->second.marked;
+  }
+
+  /// Announces all ids to `node` again and resends everything it has not
+  /// acknowledged, e.g., once it dropped a batch with an id it did not know
+  void resync(const node_id& node, const state_map& states) {
+    auto iter = peers_.find(node);
+    if (iter == peers_.end() || !iter->second.hdl)
+      return;
+    auto& p = iter->second;
+    auto hdl = std::move(p.hdl);
+    disconnect(p);
+    p.hdl = std::move(hdl);
+    connect(p);
+    request(node, p, states);
+  }
+
+  /// @returns the intrested peers per uri
+  const route_map& routes() const {
+    return routes_;
+  }
+
+  /// Forgets `node` for good, called once it has been retired
+  void remove_peer(const node_id& node) {
+    peers_.erase(node);
+    for (auto& entry : requests_)
+      entry.second.erase(node);
+    gc();
+  }
+
+  /// Stops waiting for the state of the deleted replica of `id`
+  void remove(const uri& id) {
+    auto iter = requests_.find(id);
+    if (iter == requests_.end())
+      return;
+    for (auto& node : iter->second) {
+      auto i = peers_.find(node);
+      if (i != peers_.end() && i->second.pending.erase(id) > 0
+          && i->second.pending.empty())
+        ship_states(i->second);
+    }
+    requests_.erase(iter);
+  }
+
+private:
+  /// @private
+  struct peer {
+    replicator_actor hdl;            /// Replicator, invalid if disconnected
+    uint64_t acked = 0;              /// Peer has all groups up to this one
+    uint64_t sent = 0;               /// Groups up to this one are shipped
+    uint64_t state_seq = 0;          /// Sequence number of the states
+    bool in_flight = false;          /// States are collected or shipped
+    bool remark = false;             /// States in flight predate a mark
+    bool marked = false;             /// Knows all states since the last mark
+    std::unordered_set<uri> wanted;  /// Uris replicated by the peer
+    std::unordered_set<uri> known;   /// Uris the peer has a full state of
+    std::unordered_set<uri> pending; /// Requested states
+    delta_batch states;              /// Collected states
+    std::vector<uri> shipped;        /// Uris of the shipped states
+    std::unordered_set<uri_id> announced; /// Ids known to the peer
+  };
+
+  /// @private
+  using id_route_map =
+    std::unordered_map<uri_id, std::vector<replicator_actor>>;
+
+  /// @private
+  struct buffered {
+    std::string scheme;              /// Scheme of the uri
+    std::vector<message> deltas;     /// Deltas since the last flush
+    std::vector<message> passed;     /// Passed on deltas since the last flush
+  };
+
+  /// @returns the buffer entry of `id`
+  buffered& buffer(const uri& id) {
+    auto& entry = buffer_[uri_registry::instance().intern(id)];
+    if (entry.scheme.empty())
+      entry.scheme = id.scheme();
+    return entry;
+  }
+
+  /// Ships `batch` to `p` and announces all ids `p` does not know yet
+  void ship(peer& p, uint64_t seq, wire_batch batch) {
+    uri_dictionary dict;
+    auto& reg = uri_registry::instance();
+    for (auto& entry : batch)
+      if (p.announced.emplace(entry.first).second)
+        dict.emplace_back(entry.first, reg.get(entry.first));
+    send_as(self_, p.hdl, batch_atom::value, seq, std::move(dict),
+            std::move(batch));
+  }
+
+  /// Resends all unacknowledged groups to a reconnected peer or drops its
+  /// known states if the log does not cover them anymore
+  void connect(peer& p) {
+    if (p.acked < dropped_) {
+      p.known.clear();
+      p.sent = p.acked;
+      return;
+    }
+    std::unordered_set<uri_id> known;
+    auto& reg = uri_registry::instance();
+    for (auto& id : p.known)
+      known.emplace(reg.intern(id));
+    // The receiver merges all deltas of an id at once, no need to join them
+    std::unordered_map<uri_id, std::vector<message>> deltas;
+    for (auto& entry : log_) {
+      if (entry.first <= p.acked)
+        continue;
+      for (auto& delta : entry.second)
+        if (known.count(delta.first) > 0) {
+          auto& xs = deltas[delta.first];
+          xs.insert(xs.end(), delta.second.begin(), delta.second.end());
+        }
+    }
+    if (!deltas.empty())
+      ship(p, seq_, wire_batch{deltas.begin(), deltas.end()});
+    p.sent = seq_;
+  }
+
+  /// @private
+  void disconnect(peer& p) {
+    p.hdl = replicator_actor{};
+    p.sent = p.acked;
+    p.in_flight = false;
+    p.remark = false;
+    p.marked = false;
+    p.pending.clear();
+    p.states.clear();
+    p.shipped.clear();
+    p.announced.clear();
+  }
+
+  /// Requests the states of all uris the peer does not know yet
+  void request(const node_id& node, peer& p, const state_map& states) {
+    if (p.in_flight || !p.hdl)
+      return;
+    for (auto& id : p.wanted) {
+      if (p.known.count(id) > 0)
+        continue;
+      auto iter = states.find(id);
+      if (iter == states.end())
+        continue;
+      p.pending.emplace(id);
+      auto& waiting = requests_[id];
+      if (waiting.empty())
+        send_as(self_, iter->second, copy_atom::value);
+      waiting.emplace(node);
+    }
+    if (!p.pending.empty()) {
+      // States include all deltas up to now, acknowledging them
+      // acknowledges all groups before
+      p.in_flight = true;
+      p.state_seq = ++seq_;
+    } else {
+      p.marked = true;
+    }
+  }
+
+  /// @private
+  void ship_states(peer& p) {
+    if (p.states.empty()) {
+      p.in_flight = false;
+      return;
+    }
+    wire_batch batch;
+    auto& reg = uri_registry::instance();
+    for (auto& entry : p.states) {
+      p.shipped.emplace_back(entry.first);
+      batch.emplace_back(reg.intern(entry.first), std::move(entry.second));
+    }
+    p.states.clear();
+    ship(p, p.state_seq, std::move(batch));
+  }
+
+  /// Drops all groups acknowledged by all connected peers and groups beyond
+  /// capacity
+  void gc() {
+    auto min_acked = seq_;
+    for (auto& kvp : peers_)
+      if (kvp.second.hdl)
+        min_acked = std::min(min_acked, kvp.second.acked);
+    while (!log_.empty()
+           && (log_.front().first <= min_acked || log_.size() > max_groups_)) {
+      dropped_ = log_.front().first;
+      log_.pop_front();
+    }
+  }
+
+  actor self_;                             /// Sender of all messages
+  delta_join_map joins_;                   /// Joins of buffered deltas
+  size_t max_groups_;                      /// Capacity of the log
+  std::unordered_map<uri_id, buffered> buffer_; /// Deltas since last flush
+  route_map routes_;                       /// Intrested peers per uri
+  id_route_map id_routes_;                 /// Intrested peers per id
+  id_route_map id_pass_routes_;            /// Peers of passed on deltas
+  uint64_t seq_ = 0;                       /// Last sequence number
+  uint64_t dropped_ = 0;                   /// Last dropped group
+  std::deque<std::pair<uint64_t, wire_batch>> log_; /// Retained groups
+  std::unordered_map<node_id, peer> peers_; /// State of all peers
+  std::unordered_map<uri, std::unordered_set<node_id>> requests_; /// States
+};
+
+} // namespace detail
+} // namespace crdt
+} // namespace caf
+
+#endif // CAF_CRDT_DETAIL_ANTI_ENTROPY_HPP
@@ -0,0 +1,56 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_CRDT_DETAIL_BITMAP_KERNELS_HPP
+#define CAF_CRDT_DETAIL_BITMAP_KERNELS_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace caf {
+namespace crdt {
+namespace detail {
+
+/// Word-wise kernels on bitmap containers of `roaring_bitmap`. `instance()`
+/// picks the widest implementation supported by the CPU at runtime,
+/// `scalar()` is the portable fallback.
+struct bitmap_kernels {
+  /// Stores `src & ~dst` in `delta` and `dst | src` in `dst`
+  /// @returns the number of bits set in `delta`
+  size_t (*merge)(uint64_t* dst, const uint64_t* src, uint64_t* delta,
+                  size_t n);
+
+  /// @returns the number of bits set in `xs`
+  size_t (*count)(const uint64_t* xs, size_t n);
+
+  /// Name of the instruction set, e.g. `avx2`
+  const char* name;
+
+  /// @returns the kernels selected for this CPU
+  static const bitmap_kernels& instance();
+
+  /// @returns the portable kernels
+  static const bitmap_kernels& scalar();
+};
+
+} // namespace detail
+} // namespace crdt
+} // namespace caf
+
+#endif // CAF_CRDT_DETAIL_BITMAP_KERNELS_HPP
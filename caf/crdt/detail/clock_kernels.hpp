@@ -0,0 +1,59 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_CRDT_DETAIL_CLOCK_KERNELS_HPP
+#define CAF_CRDT_DETAIL_CLOCK_KERNELS_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace caf {
+namespace crdt {
+namespace detail {
+
+/// Element-wise kernels on the value arrays of two vector clocks with
+/// identical slots. `instance()` picks the widest implementation supported
+/// by the CPU at runtime, `scalar()` is the portable fallback.
+struct clock_kernels {
+  /// Sets `greater` if any value of `lhs` is greater than in `rhs` and
+  /// `smaller` if any value of `lhs` is smaller than in `rhs`
+  void (*dominance)(const uint64_t* lhs, const uint64_t* rhs, size_t n,
+                    bool& greater, bool& smaller);
+
+  /// @returns the number of positions where `lhs` and `rhs` differ
+  size_t (*count_differ)(const uint64_t* lhs, const uint64_t* rhs, size_t n);
+
+  /// Stores the element-wise maximum of `lhs` and `rhs` in `lhs`
+  void (*join)(uint64_t* lhs, const uint64_t* rhs, size_t n);
+
+  /// Name of the instruction set, e.g. `avx2`
+  const char* name;
+
+  /// @returns the kernels selected for this CPU
+  static const clock_kernels& instance();
+
+  /// @returns the portable kernels
+  static const clock_kernels& scalar();
+};
+
+} // namespace detail
+} // namespace crdt
+} // namespace caf
+
+#endif // CAF_CRDT_DETAIL_CLOCK_KERNELS_HPP
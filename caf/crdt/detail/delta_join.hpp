@@ -0,0 +1,67 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_CRDT_DETAIL_DELTA_JOIN_HPP
+#define CAF_CRDT_DETAIL_DELTA_JOIN_HPP
+
+#include "caf/message.hpp"
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+namespace caf {
+namespace crdt {
+namespace detail {
+
+/// Joins buffered delta messages of one CRDT type into a single delta
+using delta_join = message (*)(const std::vector<message>&);
+
+/// Maps CRDT type names, i.e., uri schemes, to their join
+using delta_join_map = std::unordered_map<std::string, delta_join>;
+
+/// Replaces the buffered deltas in `xs` by their join if `joins` contains
+/// a join for `scheme`
+inline void join_buffered(const delta_join_map& joins,
+                          const std::string& scheme,
+                          std::vector<message>& xs) {
+  if (xs.size() < 2)
+    return;
+  auto join = joins.find(scheme);
+  if (join == joins.end())
+    return;
+  auto joined = join->second(xs);
+  xs.clear();
+  xs.emplace_back(std::move(joined));
+}
+
+/// Joins all deltas in `xs`, which must contain `T` only
+template <class T>
+message join_deltas(const std::vector<message>& xs) {
+  T result;
+  for (auto& x : xs)
+    x.apply([&](const T& delta) { result.merge(delta); });
+  return make_message(std::move(result));
+}
+
+} // namespace detail
+} // namespace crdt
+} // namespace caf
+
+#endif // CAF_CRDT_DETAIL_DELTA_JOIN_HPP
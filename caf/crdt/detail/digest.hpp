@@ -0,0 +1,287 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_CRDT_DETAIL_DIGEST_HPP
+#define CAF_CRDT_DETAIL_DIGEST_HPP
+
+#include "caf/binary_serializer.hpp"
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <type_traits>
+#include <unordered_map>
+
+namespace caf {
+namespace crdt {
+namespace detail {
+
+/// A range of key fingerprints in the digest tree of a set-like replica,
+/// encoded as `(prefix << 4) | depth`. A range of depth `d` contains all keys
+/// whose top `4 * d` bits equal `prefix`, the root has depth 0.
+using digest_range = uint64_t;
+
+/// Number of children of a range in the digest tree
+constexpr size_t digest_fanout = 16;
+
+/// Maximum depth of a range, its prefix takes 60 bits
+constexpr uint64_t digest_max_depth = 15;
+
+/// Ranges with at most this many entries are exchanged instead of descending
+/// into their children
+constexpr size_t digest_leaf_size = 16;
+
+/// Scrambles the bits of `x` (finalizer of SplitMix64)
+inline uint64_t digest_mix(uint64_t x) {
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ull;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebull;
+  return x ^ (x >> 31);
+}
+
+/// Adds the fingerprint `x` of an entry to `acc`. Sums do not depend on the
+/// order of entries, states which order entries by interned ids use them.
+inline void fingerprint_add(uint64_t& acc, uint64_t x) {
+  acc += digest_mix(x);
+}
+
+/// Appends the fingerprint `x` of the next field of a state to `seed`
+inline uint64_t fingerprint_combine(uint64_t seed, uint64_t x) {
+  return digest_mix(seed ^ digest_mix(x));
+}
+
+/// Evaluates to `true` if `T` computes its own fingerprint, which types do
+/// whose serialization depends on the process, e.g., on interned ids
+template <class T>
+class has_fingerprint {
+  template <class U>
+  static auto check(const U* x) -> decltype(x->fingerprint(), std::true_type{});
+
+  template <class U>
+  static std::false_type check(...);
+
+public:
+  static constexpr bool value = decltype(check<T>(nullptr))::value;
+};
+
+/// @returns the fingerprint of an arithmetic value
+template <class T>
+typename std::enable_if<std::is_arithmetic<T>::value, uint64_t>::type
+fingerprint(const T& x) {
+  return digest_mix(static_cast<uint64_t>(x));
+}
+
+/// @returns the fingerprint `x` computes of itself
+template <class T>
+typename std::enable_if<has_fingerprint<T>::value, uint64_t>::type
+fingerprint(const T& x) {
+  return x.fingerprint();
+}
+
+/// @returns the fingerprint of the binary serialization of `x`
+template <class T>
+typename std::enable_if<!std::is_arithmetic<T>::value
+                        && !has_fingerprint<T>::value, uint64_t>::type
+fingerprint(const T& x) {
+  std::vector<char> buf;
+  binary_serializer sink{nullptr, buf};
+  sink & const_cast<T&>(x);
+  uint64_t result = 14695981039346656037ull; // FNV-1a
+  for (auto c : buf) {
+    result ^= static_cast<uint8_t>(c);
+    result *= 1099511628211ull;
+  }
+  return result;
+}
+
+/// @returns the depth of `x`
+inline uint64_t digest_depth(digest_range x) {
+  return x & 0x0F;
+}
+
+/// @returns the range of depth `depth` containing `key`
+inline digest_range digest_range_of(uint64_t key, uint64_t depth) {
+  return depth == 0 ? 0 : ((key >> (64 - 4 * depth)) << 4) | depth;
+}
+
+/// @returns the children of `x`
+inline std::vector<digest_range> digest_children(digest_range x) {
+  auto depth = digest_depth(x) + 1;
+  std::vector<digest_range> result;
+  result.reserve(digest_fanout);
+  for (uint64_t i = 0; i < digest_fanout; ++i)
+    result.emplace_back(((((x >> 4) << 4) | i) << 4) | depth);
+  return result;
+}
+
+/// Looks up the range of a key among ranges which do not overlap
+class digest_index {
+public:
+  static constexpr size_t npos = static_cast<size_t>(-1);
+
+  explicit digest_index(const std::vector<digest_range>& xs) {
+    for (size_t i = 0; i < xs.size(); ++i) {
+      auto depth = digest_depth(xs[i]);
+      if (depth > digest_max_depth)
+        continue;
+      auto last = depths_.end();
+      if (pos_.emplace(xs[i], i).second
+          && std::find(depths_.begin(), last, depth) == last)
+        depths_.emplace_back(depth);
+    }
+  }
+
+  /// @returns the position of the range containing `key`, `npos` if none does
+  size_t find(uint64_t key) const {
+    for (auto depth : depths_) {
+      auto iter = pos_.find(digest_range_of(key, depth));
+      if (iter != pos_.end())
+        return iter->second;
+    }
+    return npos;
+  }
+
+private:
+  std::vector<uint64_t> depths_;                 /// Depths of all ranges
+  std::unordered_map<digest_range, size_t> pos_; /// Position of each range
+};
+
+/// Probes whether a type digests its entries
+struct digest_probe {
+  void operator()(uint64_t, uint64_t) const {
+    // nop
+  }
+};
+
+/// Evaluates to `true` if `T` digests its entries by key, i.e., calls a
+/// function object with the key and entry fingerprint of each entry
+template <class T>
+class has_digest {
+  template <class U>
+  static auto check(const U* x)
+  -> decltype(x->digest(digest_probe{}), std::true_type{});
+
+  template <class U>
+  static std::false_type check(...);
+
+public:
+  static constexpr bool value = decltype(check<T>(nullptr))::value;
+};
+
+/// Hashes and sizes of ranges of a digest tree
+struct digest_summary {
+  std::vector<uint64_t> hashes;
+  std::vector<size_t> sizes;
+};
+
+/// @returns the hashes and sizes of `ranges` in `x`. Ranges sum their
+///          entries, hence hashes do not depend on the order of entries.
+template <class T>
+typename std::enable_if<has_digest<T>::value, digest_summary>::type
+digest_summarize(const T& x, const std::vector<digest_range>& ranges) {
+  digest_summary result;
+  result.hashes.resize(ranges.size());
+  result.sizes.resize(ranges.size());
+  digest_index index{ranges};
+  x.digest([&](uint64_t key, uint64_t fp) {
+    auto i = index.find(key);
+    if (i != digest_index::npos) {
+      fingerprint_add(result.hashes[i], fp);
+      ++result.sizes[i];
+    }
+  });
+  return result;
+}
+
+/// Types without entries are digested as a whole, i.e., by their root
+template <class T>
+typename std::enable_if<!has_digest<T>::value, digest_summary>::type
+digest_summarize(const T& x, const std::vector<digest_range>& ranges) {
+  digest_summary result;
+  for (auto range : ranges) {
+    result.hashes.emplace_back(range == 0 ? fingerprint(x) : 0);
+    result.sizes.emplace_back(0);
+  }
+  return result;
+}
+
+/// @returns the root of the digest tree of `x`
+template <class T>
+uint64_t digest_root(const T& x) {
+  return digest_summarize(x, {0}).hashes.front();
+}
+
+/// Result of comparing ranges of a digest tree with the hashes of a peer
+struct digest_step {
+  std::vector<digest_range> resolved; /// Small differing ranges, exchanged
+  std::vector<digest_range> split;    /// Large differing ranges, descended
+  std::vector<uint64_t> hashes;       /// Local hashes of `split`
+};
+
+/// Compares `ranges` of `x` with the `hashes` of a peer. Differing ranges are
+/// exchanged as a whole if they are small or cannot be split, otherwise
+/// their children are compared in the next step.
+template <class T>
+digest_step digest_compare(const T& x, const std::vector<digest_range>& ranges,
+                           const std::vector<uint64_t>& hashes) {
+  digest_step result;
+  if (ranges.size() != hashes.size())
+    return result;
+  auto local = digest_summarize(x, ranges);
+  for (size_t i = 0; i < ranges.size(); ++i) {
+    if (local.hashes[i] == hashes[i]
+        || digest_depth(ranges[i]) > digest_max_depth)
+      continue;
+    if (!has_digest<T>::value || local.sizes[i] <= digest_leaf_size
+        || digest_depth(ranges[i]) == digest_max_depth) {
+      result.resolved.emplace_back(ranges[i]);
+    } else {
+      auto xs = digest_children(ranges[i]);
+      result.split.insert(result.split.end(), xs.begin(), xs.end());
+    }
+  }
+  if (!result.split.empty())
+    result.hashes = digest_summarize(x, result.split).hashes;
+  return result;
+}
+
+/// @returns the entries of `x` in `ranges`
+template <class T>
+typename std::enable_if<has_digest<T>::value, T>::type
+slice_of(const T& x, const std::vector<digest_range>& ranges) {
+  digest_index index{ranges};
+  return x.slice([&](uint64_t key) {
+    return index.find(key) != digest_index::npos;
+  });
+}
+
+/// Types without entries are transferred as a whole
+template <class T>
+typename std::enable_if<!has_digest<T>::value, T>::type
+slice_of(const T& x, const std::vector<digest_range>&) {
+  return x;
+}
+
+} // namespace detail
+} // namespace crdt
+} // namespace caf
+
+#endif // CAF_CRDT_DETAIL_DIGEST_HPP
@@ -0,0 +1,275 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_CRDT_DETAIL_DIRECTORY_LAYER_HPP
+#define CAF_CRDT_DETAIL_DIRECTORY_LAYER_HPP
+
+#include "caf/node_id.hpp"
+
+#include "caf/crdt/uri.hpp"
+#include "caf/crdt/replicator_actor.hpp"
+
+#include "caf/crdt/detail/abstract_distribution_layer.hpp"
+
+#include <deque>
+#include <tuple>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace caf {
+namespace crdt {
+namespace detail {
+
+/// Keeps the directory of replica ids, i.e., which node replicates which
+/// uris, and leaves the dissemination of deltas to its subclasses.
+class directory_layer : public abstract_distribution_layer {
+
+  ///
+  struct node_data {
+    size_t version;
+    replicator_actor replicator;
+    std::unordered_set<uri> filter;
+  };
+
+  using map_type = std::unordered_map<node_id, node_data>;
+  using uri_to_nodeid_type = std::unordered_map<uri, std::set<node_id>>;
+
+public:
+  /// Number of local id changes retained for incremental pushes
+  static constexpr size_t max_id_log = 4096;
+
+  /// Construct a directory layer
+  template <class ReplicatorImpl>
+  directory_layer(ReplicatorImpl* impl)
+      : impl_{actor_cast<actor>(impl)},
+        local_{0, actor_cast<replicator_actor>(impl), {}} {
+    // nop
+  }
+
+  /// Add a freshly discovered node
+  /// @param nid node to add
+  void add_new_node(const node_id& nid) override {
+    auto& mm = impl_->home_system().middleman();
+    auto query = mm.remote_lookup(replicator_atom::value, nid);
+    if (query) {
+      auto repl = actor_cast<replicator_actor>(query);
+      node_data data{0, repl, {}};
+      store_.emplace(nid, std::move(data));
+      send_as(impl_, repl, get_ids_atom::value, size_t{0});
+    }
+  }
+
+  /// A node is no longer reachable, we have to remove it from our lists
+  /// @param nid node to remove
+  void remove_node(const node_id& nid) override {
+    store_.erase(nid);
+    for (auto& entry : uri_to_nodes_)
+      entry.second.erase(nid);
+  }
+
+
+  /// Update a map entry
+  /// @param nid      regarding node
+  /// @param version  version of set
+  /// @param ids      set of ids
+  void update(const node_id& nid, size_t version,
+              std::unordered_set<uri>&& ids) override {
+    auto& data = store_[nid];
+    if (version > data.version) {
+      // Remove old ids from mapping
+      for (auto& u : data.filter) uri_to_nodes_[u].erase(nid);
+      // Set new values (uris, version)
+      data.filter = std::move(ids);
+      data.version = version;
+      // Add new ids to mapping
+      for (auto& u : data.filter) uri_to_nodes_[u].emplace(nid);
+    }
+  }
+
+  /// Apply changes of the ids of a node, which are based on version `base`.
+  /// If this layer has not seen `base`, the node is asked for its ids.
+  /// @param nid      regarding node
+  /// @param base     version the changes are based on
+  /// @param version  version of set after the changes
+  /// @param added    added ids
+  /// @param removed  removed ids
+  void update(const node_id& nid, size_t base, size_t version,
+              const std::unordered_set<uri>& added,
+              const std::unordered_set<uri>& removed) override {
+    auto iter = store_.find(nid);
+    if (iter == store_.end())
+      return;
+    auto& data = iter->second;
+    if (version <= data.version)
+      return;
+    if (base != data.version) {
+      send_as(impl_, data.replicator, get_ids_atom::value, data.version);
+      return;
+    }
+    for (auto& u : removed) {
+      data.filter.erase(u);
+      uri_to_nodes_[u].erase(nid);
+    }
+    for (auto& u : added) {
+      data.filter.emplace(u);
+      uri_to_nodes_[u].emplace(nid);
+    }
+    data.version = version;
+  }
+
+  /// Locally add a replic Id, this is called, when a new replica<T> is spawned
+  /// @param u uri to add
+  void add_id(const uri& u) override {
+    modify_ids(u, false);
+  }
+
+  /// Locally remove a replic id
+  /// @param u uri to remove
+  void remove_id(const uri& u) override {
+    modify_ids(u, true);
+  }
+
+  /// Push the changes of our replic Ids since the last push to all nodes.
+  /// Nodes which missed a push ask for the missing changes via `get_ids`.
+  void push_ids() override {
+    if (pushed_ == local_.version)
+      return;
+    for (auto& entry : store_)
+      send_ids(entry.second.replicator, pushed_);
+    pushed_ = local_.version;
+  }
+
+  /// A node has asked us to respond with our replic Ids, if the version has
+  /// changed. Seen is the last seen version by the sender, if we have a newer
+  /// version, respond with the changes since or with our actual entry.
+  /// @param intrested_node the node intrested in our ids
+  /// @param seen the last seen version of instrested node
+  void get_ids(const node_id& intrested_node, size_t seen) override {
+    if (seen == local_.version)
+      return;
+    auto iter = store_.find(intrested_node);
+    if (iter == store_.end())
+      return;
+    send_ids(iter->second.replicator, seen);
+  }
+
+  /// Get all intrested nodes to a uri
+  /// @param Replica-ID
+  /// @returns all (known) intrested nodes
+  std::set<replicator_actor> get_intrested(const uri& id) const override {
+    std::set<replicator_actor> result;
+    for (auto& entry : store_) {
+      auto& set = entry.second.filter;
+      if (set.find(id) != set.end())
+        result.emplace(entry.second.replicator);
+    }
+    return result;
+  }
+
+  /// @returns the replicators of all intrested nodes per uri
+  route_map routes() const override {
+    route_map result;
+    for (auto& entry : uri_to_nodes_) {
+      if (entry.second.empty())
+        continue;
+      auto& xs = result[entry.first];
+      for (auto& node : entry.second) {
+        auto iter = store_.find(node);
+        if (iter != store_.end())
+          xs.emplace_back(iter->second.replicator);
+      }
+    }
+    return result;
+  }
+
+  /// @returns the replicator of `nid`, an invalid handle if `nid` is unknown
+  replicator_actor replicator_of(const node_id& nid) const override {
+    auto iter = store_.find(nid);
+    return iter != store_.end() ? iter->second.replicator : replicator_actor{};
+  }
+
+protected:
+  /// @returns the number of known nodes
+  size_t nodes() const {
+    return store_.size();
+  }
+
+  /// Calls `f` with the replicator of each node intrested in `id`
+  template <class F>
+  void for_each_intrested(const uri& id, F f) const {
+    auto iter = uri_to_nodes_.find(id);
+    if (iter == uri_to_nodes_.end())
+      return;
+    for (auto& node : iter->second) {
+      auto i = store_.find(node);
+      if (i != store_.end())
+        f(i->second.replicator);
+    }
+  }
+
+private:
+  /// @private
+  inline void modify_ids(const uri& u, bool erase) {
+    local_.version++;
+    if (erase) local_.filter.erase(u);
+    else       local_.filter.emplace(u);
+    id_log_.emplace_back(u, erase);
+    if (id_log_.size() > max_id_log)
+      id_log_.pop_front();
+  }
+
+  /// Sends the changes since version `seen` or the whole entry if
+  /// the log of changes does not reach back to `seen`
+  void send_ids(const replicator_actor& to, size_t seen) {
+    if (seen > local_.version || local_.version - seen > id_log_.size()) {
+      send_as(impl_, to, local_.version, local_.filter);
+      return;
+    }
+    std::unordered_set<uri> added;
+    std::unordered_set<uri> removed;
+    auto first = id_log_.size() - (local_.version - seen);
+    for (auto i = first; i < id_log_.size(); ++i) {
+      auto& change = id_log_[i];
+      if (change.second) {
+        added.erase(change.first);
+        removed.emplace(change.first);
+      } else {
+        removed.erase(change.first);
+        added.emplace(change.first);
+      }
+    }
+    send_as(impl_, to, ids_delta_atom::value, seen, local_.version,
+            std::move(added), std::move(removed));
+  }
+
+  actor impl_;             /// Sender of all messages
+  node_data local_;        /// Information of local node
+  std::deque<std::pair<uri, bool>> id_log_; /// Latest changes (uri, erased)
+  size_t pushed_ = 0;      /// Version of the last push
+  map_type store_;         /// Information of remote nodes (node_id => node_data)
+  uri_to_nodeid_type uri_to_nodes_; /// Maps uris to set of nodes
+};
+
+} // namespace detail
+} // namespace crdt
+} // namespace caf
+
+#endif // CAF_CRDT_DETAIL_DIRECTORY_LAYER_HPP
@@ -0,0 +1,182 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_CRDT_DETAIL_FLAT_SET_HPP
+#define CAF_CRDT_DETAIL_FLAT_SET_HPP
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+#include <initializer_list>
+
+namespace caf {
+namespace crdt {
+namespace detail {
+
+/// Set stored as a sorted vector. Lookups are binary searches on contiguous
+/// memory and elements need no heap node each, but inserting a single
+/// element moves all greater elements. Suited for read-heavy sets.
+template <class T, class Compare = std::less<T>>
+class flat_set {
+public:
+  using value_type = T;
+  using key_type = T;
+  using key_compare = Compare;
+  using size_type = size_t;
+  using const_iterator = typename std::vector<T>::const_iterator;
+  using iterator = const_iterator;
+
+  flat_set() = default;
+
+  flat_set(std::initializer_list<T> xs) {
+    insert(xs.begin(), xs.end());
+  }
+
+  /// Inserts `x` if it is not in the set yet
+  /// @returns an iterator to `x` and `true` if `x` has been inserted
+  std::pair<iterator, bool> emplace(const T& x) {
+    auto i = std::lower_bound(xs_.begin(), xs_.end(), x, cmp_);
+    if (i != xs_.end() && !cmp_(x, *i))
+      return {i, false};
+    return {xs_.insert(i, x), true};
+  }
+
+  /// Inserts `x` if it is not in the set yet, starting the search at `hint`.
+  /// Inserting in ascending order at `end()` takes amortized constant time.
+  iterator insert(const_iterator hint, const T& x) {
+    auto first = xs_.cbegin();
+    auto last = xs_.cend();
+    // Only search the whole range if `hint` is not the right position
+    if ((hint != first && !cmp_(*(hint - 1), x))
+        || (hint != last && cmp_(*hint, x)))
+      hint = std::lower_bound(first, last, x, cmp_);
+    if (hint != last && !cmp_(x, *hint))
+      return hint;
+    return xs_.insert(xs_.begin() + (hint - first), x);
+  }
+
+  /// Inserts all elements of the range `[first, last)`
+  template <class Iterator>
+  void insert(Iterator first, Iterator last) {
+    auto n = xs_.size();
+    xs_.insert(xs_.end(), first, last);
+    auto mid = xs_.begin() + static_cast<std::ptrdiff_t>(n);
+    std::sort(mid, xs_.end(), cmp_);
+    std::inplace_merge(xs_.begin(), mid, xs_.end(), cmp_);
+    auto eq = [&](const T& lhs, const T& rhs) {
+      return !cmp_(lhs, rhs) && !cmp_(rhs, lhs);
+    };
+    xs_.erase(std::unique(xs_.begin(), xs_.end(), eq), xs_.end());
+  }
+
+  /// Inserts all elements of `other` in linear time. Appends the elements
+  /// which have been missing in `this` to `added`, which must either be
+  /// empty or contain only elements less than those of `other`.
+  void merge(const flat_set& other, flat_set& added) {
+    auto n = xs_.size();
+    auto first_added = added.xs_.size();
+    // Collect missing elements, they are sorted as well
+    auto i = xs_.begin();
+    for (auto& y : other.xs_) {
+      while (i != xs_.end() && cmp_(*i, y))
+        ++i;
+      if (i == xs_.end() || cmp_(y, *i))
+        added.xs_.push_back(y);
+    }
+    auto missing = added.xs_.size() - first_added;
+    if (missing == 0)
+      return;
+    // Merge back to front, this allows to grow `xs_` in place
+    xs_.resize(n + missing);
+    auto src = n;
+    auto k = n + missing;
+    auto j = added.xs_.size();
+    while (j > first_added) {
+      if (src > 0 && cmp_(added.xs_[j - 1], xs_[src - 1]))
+        xs_[--k] = std::move(xs_[--src]);
+      else
+        xs_[--k] = added.xs_[--j];
+    }
+  }
+
+  /// @returns an iterator to `x` or `end()`
+  const_iterator find(const T& x) const {
+    auto i = std::lower_bound(xs_.begin(), xs_.end(), x, cmp_);
+    return i != xs_.end() && !cmp_(x, *i) ? i : xs_.end();
+  }
+
+  /// @returns `1` if `x` is in the set, `0` otherwise
+  size_t count(const T& x) const {
+    return find(x) != xs_.end() ? 1 : 0;
+  }
+
+  /// Reserves memory for `n` elements
+  void reserve(size_t n) { xs_.reserve(n); }
+
+  void clear() { xs_.clear(); }
+
+  size_t size() const { return xs_.size(); }
+
+  bool empty() const { return xs_.empty(); }
+
+  const_iterator begin() const { return xs_.begin(); }
+
+  const_iterator end() const { return xs_.end(); }
+
+  const_iterator cbegin() const { return xs_.cbegin(); }
+
+  const_iterator cend() const { return xs_.cend(); }
+
+  /// @private
+  template <class Processor>
+  friend void serialize(Processor& proc, flat_set& x) {
+    proc & x.xs_;
+    // Restore the invariant, the input is not trusted to be sorted
+    if (!std::is_same<typename Processor::is_saving, std::true_type>::value) {
+      auto xs = std::move(x.xs_);
+      x.xs_.clear();
+      x.insert(xs.begin(), xs.end());
+    }
+  }
+
+  friend bool operator==(const flat_set& lhs, const flat_set& rhs) {
+    return lhs.xs_ == rhs.xs_;
+  }
+
+  friend bool operator!=(const flat_set& lhs, const flat_set& rhs) {
+    return lhs.xs_ != rhs.xs_;
+  }
+
+  friend bool operator<(const flat_set& lhs, const flat_set& rhs) {
+    return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(),
+                                        rhs.end(), lhs.cmp_);
+  }
+
+private:
+  std::vector<T> xs_; /// Sorted elements without duplicates
+  Compare cmp_;       /// Order of elements
+};
+
+} // namespace detail
+} // namespace crdt
+} // namespace caf
+
+#endif // CAF_CRDT_DETAIL_FLAT_SET_HPP
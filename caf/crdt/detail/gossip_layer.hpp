@@ -0,0 +1,256 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_CRDT_DETAIL_GOSSIP_LAYER_HPP
+#define CAF_CRDT_DETAIL_GOSSIP_LAYER_HPP
+
+#include "caf/send.hpp"
+#include "caf/node_id.hpp"
+
+#include "caf/crdt/uri.hpp"
+#include "caf/crdt/atom_types.hpp"
+#include "caf/crdt/replicator_actor.hpp"
+
+#include "caf/crdt/detail/delta_join.hpp"
+#include "caf/crdt/detail/wire_encoder.hpp"
+#include "caf/crdt/detail/directory_layer.hpp"
+
+#include <deque>
+#include <random>
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+#include <unordered_set>
+
+namespace caf {
+namespace crdt {
+namespace detail {
+
+/// Samples peers uniformly at random. Every call draws a fresh sample, hence
+/// the peers of a node change from round to round.
+class peer_sampler {
+public:
+  peer_sampler() : rng_{std::random_device{}()} {
+    // nop
+  }
+
+  /// Shrinks `xs` to a random sample of at most `k` elements
+  template <class T>
+  void sample(std::vector<T>& xs, size_t k) {
+    if (xs.size() <= k)
+      return;
+    // Partial Fisher-Yates shuffle of the first `k` elements
+    for (size_t i = 0; i < k; ++i) {
+      std::uniform_int_distribution<size_t> dist{i, xs.size() - 1};
+      std::swap(xs[i], xs[dist(rng_)]);
+    }
+    xs.resize(k);
+  }
+
+private:
+  std::minstd_rand rng_;
+};
+
+/// Disseminates deltas epidemically. Each flush becomes a rumor which is
+/// pushed to `fanout` random intrested nodes, every node receiving it for
+/// the first time pushes it to `fanout` random nodes again until its hops
+/// are used up. Hence each node sends `fanout` messages per rumor, the
+/// number of rounds until all nodes have a rumor grows with the logarithm
+/// of the cluster size. Reconciliation rounds pull from `fanout` random
+/// nodes per uri. Rumors carry interned ids and may get lost, hence each
+/// rumor announces the uris of all its ids.
+class gossip_layer : public directory_layer {
+public:
+  /// Rumors remembered to drop duplicates
+  static constexpr size_t max_seen = 65536;
+
+  /// Construct a gossip layer
+  /// @param joins used to coalesce buffered deltas per uri scheme
+  /// @param fanout number of nodes each node pushes a rumor to
+  template <class ReplicatorImpl>
+  gossip_layer(ReplicatorImpl* impl, delta_join_map joins, size_t fanout)
+      : directory_layer(impl),
+        self_{actor_cast<actor>(impl)},
+        node_{impl->node()},
+        joins_{std::move(joins)},
+        fanout_{std::max(fanout, size_t{1})} {
+    // nop
+  }
+
+  /// Add update into update buffer
+  /// @param id of update as uri
+  /// @param msg containing the update
+  void publish(const uri& id, const message& msg) override {
+    buffer_[id].emplace_back(msg);
+  }
+
+  /// Spreads the update buffer as a new rumor
+  void flush_buffer() override {
+    delta_batch deltas;
+    for (auto& entry : buffer_) {
+      if (entry.second.empty())
+        continue;
+      join_buffered(joins_, entry.first.scheme(), entry.second);
+      deltas.emplace(entry.first, std::move(entry.second));
+    }
+    buffer_.clear();
+    if (deltas.empty())
+      return;
+    auto seq = ++seq_;
+    remember(node_, seq);
+    spread(node_, seq, hops(), deltas);
+  }
+
+  /// Forwards a new rumor to `fanout` random nodes
+  /// @param origin node which has published the deltas
+  /// @param seq    sequence number of the rumor at `origin`
+  /// @param ttl    remaining hops of the rumor
+  /// @param deltas deltas per uri
+  /// @returns `true` if the rumor is new, its deltas have to be merged
+  bool rumor(const node_id& origin, uint64_t seq, uint32_t ttl,
+             const delta_batch& deltas) {
+    if (!remember(origin, seq))
+      return false;
+    if (ttl > 0)
+      spread(origin, seq, ttl - 1, deltas);
+    return true;
+  }
+
+  /// Rumors are not acknowledged, reconciliation rounds repair lost ones
+  void sync(const state_map&) override {
+    // nop
+  }
+
+  /// @private
+  void ack(const node_id&, uint64_t, const state_map&) override {
+    // nop
+  }
+
+  /// @private
+  void state(const uri&, message) override {
+    // nop
+  }
+
+  /// @private
+  void drop_state(const uri&) override {
+    // nop
+  }
+
+  /// Rumors keep no state per peer
+  void retire_node(const node_id&) override {
+    // nop
+  }
+
+  /// Rumors are not acknowledged, this layer never observes stability
+  bool mark(const state_map&) override {
+    return false;
+  }
+
+  /// @private
+  bool marked(const node_id&) const override {
+    return false;
+  }
+
+  /// Rumors are not numbered per peer, there is nothing to resend
+  void resync(const node_id&, const state_map&) override {
+    // nop
+  }
+
+  /// @returns `fanout` random intrested nodes per uri, i.e., each
+  ///          reconciliation round is a push-pull with a few nodes only
+  route_map routes() const override {
+    auto result = directory_layer::routes();
+    for (auto& entry : result)
+      sampler_.sample(entry.second, fanout_);
+    return result;
+  }
+
+private:
+  /// @returns the hops of a new rumor, enough to reach all nodes with high
+  ///          probability
+  uint32_t hops() const {
+    uint32_t result = 1;
+    for (auto n = nodes(); n > 1; n /= fanout_ + 1)
+      ++result;
+    return result + 1;
+  }
+
+  /// @returns `true` if the rumor was not seen before
+  bool remember(const node_id& origin, uint64_t seq) {
+    auto key = std::make_pair(origin, seq);
+    if (!seen_.emplace(key).second)
+      return false;
+    seen_order_.emplace_back(std::move(key));
+    if (seen_order_.size() > max_seen) {
+      seen_.erase(seen_order_.front());
+      seen_order_.pop_front();
+    }
+    return true;
+  }
+
+  /// Pushes a rumor to `fanout` random nodes intrested in one of its uris
+  void spread(const node_id& origin, uint64_t seq, uint32_t ttl,
+              const delta_batch& deltas) {
+    std::vector<replicator_actor> peers;
+    std::unordered_set<node_id> known{origin, node_};
+    for (auto& entry : deltas)
+      for_each_intrested(entry.first, [&](const replicator_actor& hdl) {
+        if (known.emplace(hdl.node()).second)
+          peers.emplace_back(hdl);
+      });
+    sampler_.sample(peers, fanout_);
+    if (peers.empty())
+      return;
+    // Rumors may get lost, each of them announces all of its ids
+    auto xs = wire_encoder::encode(deltas);
+    auto dict = wire_encoder::announce(xs);
+    for (auto& hdl : peers)
+      send_as(self_, hdl, gossip_atom::value, origin, seq, ttl, dict, xs);
+  }
+
+  /// @private
+  struct rumor_hash {
+    size_t operator()(const std::pair<node_id, uint64_t>& x) const {
+      auto h = std::hash<node_id>{}(x.first);
+      return h ^ (std::hash<uint64_t>{}(x.second) + 0x9e3779b9
+                  + (h << 6) + (h >> 2));
+    }
+  };
+
+  /// @private
+  using rumor_set = std::unordered_set<std::pair<node_id, uint64_t>,
+                                       rumor_hash>;
+
+  actor self_;                    /// Sender of all messages
+  node_id node_;                  /// Local node
+  delta_join_map joins_;          /// Joins of buffered deltas
+  size_t fanout_;                 /// Nodes per push and pull
+  mutable peer_sampler sampler_;  /// Draws random nodes
+  delta_batch buffer_;            /// Deltas since the last flush
+  uint64_t seq_ = 0;              /// Last rumor of this node
+  rumor_set seen_;                /// Remembered rumors
+  std::deque<std::pair<node_id, uint64_t>> seen_order_; /// Oldest first
+};
+
+} // namespace detail
+} // namespace crdt
+} // namespace caf
+
+#endif // CAF_CRDT_DETAIL_GOSSIP_LAYER_HPP
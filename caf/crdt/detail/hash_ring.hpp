@@ -0,0 +1,74 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_CRDT_DETAIL_HASH_RING_HPP
+#define CAF_CRDT_DETAIL_HASH_RING_HPP
+
+#include "caf/node_id.hpp"
+
+#include "caf/crdt/uri.hpp"
+
+#include <map>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <unordered_set>
+
+namespace caf {
+namespace crdt {
+namespace detail {
+
+/// Consistent-hash ring over nodes. Each node owns `vnodes` points on the
+/// ring, a uri is owned by the first distinct nodes clockwise from its hash.
+/// Points only depend on the string representation of nodes and uris,
+/// hence all nodes agree on the owners of a uri.
+class hash_ring {
+public:
+  /// @param vnodes number of points per node
+  explicit hash_ring(size_t vnodes = 64);
+
+  /// Adds `node` to the ring
+  void add(const node_id& node);
+
+  /// Removes `node` from the ring
+  void remove(const node_id& node);
+
+  /// @returns `true` if `node` is on the ring
+  bool contains(const node_id& node) const;
+
+  /// @returns the first `n` distinct nodes clockwise from the hash of `id`
+  std::vector<node_id> owners(const uri& id, size_t n) const;
+
+  /// @returns `true` if `node` is one of the first `n` owners of `id`
+  bool owns(const node_id& node, const uri& id, size_t n) const;
+
+private:
+  /// @returns the point of the `i`-th virtual node of `node`
+  static uint64_t point(const std::string& node, size_t i);
+
+  size_t vnodes_;                        /// Points per node
+  std::map<uint64_t, node_id> points_;   /// Ring
+  std::unordered_set<node_id> nodes_;    /// Nodes on the ring
+};
+
+} // namespace detail
+} // namespace crdt
+} // namespace caf
+
+#endif // CAF_CRDT_DETAIL_HASH_RING_HPP
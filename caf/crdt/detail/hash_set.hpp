@@ -0,0 +1,190 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_CRDT_DETAIL_HASH_SET_HPP
+#define CAF_CRDT_DETAIL_HASH_SET_HPP
+
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+#include <initializer_list>
+
+namespace caf {
+namespace crdt {
+namespace detail {
+
+/// Grow-only hash set with open addressing. Elements are stored densely in
+/// insertion order, the table stores their index and is probed linearly.
+/// Since elements are never erased, the table needs no tombstones. Suited
+/// for large sets with frequent membership tests, iteration is unordered.
+template <class T, class Hash = std::hash<T>, class Equal = std::equal_to<T>>
+class hash_set {
+public:
+  using value_type = T;
+  using key_type = T;
+  using size_type = size_t;
+  using const_iterator = typename std::vector<T>::const_iterator;
+  using iterator = const_iterator;
+
+  hash_set() = default;
+
+  hash_set(std::initializer_list<T> xs) {
+    insert(xs.begin(), xs.end());
+  }
+
+  /// Inserts `x` if it is not in the set yet
+  /// @returns an iterator to `x` and `true` if `x` has been inserted
+  std::pair<iterator, bool> emplace(const T& x) {
+    if ((xs_.size() + 1) * 10 > table_.size() * 7)
+      rehash(std::max(table_.size() * 2, min_capacity));
+    auto pos = probe(x);
+    if (table_[pos] != 0)
+      return {xs_.begin() + (table_[pos] - 1), false};
+    xs_.push_back(x);
+    table_[pos] = static_cast<index_type>(xs_.size());
+    return {xs_.end() - 1, true};
+  }
+
+  /// Inserts `x` if it is not in the set yet, `hint` is ignored
+  iterator insert(const_iterator, const T& x) {
+    return emplace(x).first;
+  }
+
+  /// Inserts all elements of the range `[first, last)`
+  template <class Iterator>
+  void insert(Iterator first, Iterator last) {
+    for (; first != last; ++first)
+      emplace(*first);
+  }
+
+  /// @returns an iterator to `x` or `end()`
+  const_iterator find(const T& x) const {
+    if (table_.empty())
+      return xs_.end();
+    auto pos = probe(x);
+    return table_[pos] != 0 ? xs_.begin() + (table_[pos] - 1) : xs_.end();
+  }
+
+  /// @returns `1` if `x` is in the set, `0` otherwise
+  size_t count(const T& x) const {
+    return find(x) != xs_.end() ? 1 : 0;
+  }
+
+  /// Reserves memory for `n` elements
+  void reserve(size_t n) {
+    xs_.reserve(n);
+    auto capacity = min_capacity;
+    while (n * 10 > capacity * 7)
+      capacity *= 2;
+    if (capacity > table_.size())
+      rehash(capacity);
+  }
+
+  void clear() {
+    xs_.clear();
+    table_.clear();
+  }
+
+  size_t size() const { return xs_.size(); }
+
+  bool empty() const { return xs_.empty(); }
+
+  const_iterator begin() const { return xs_.begin(); }
+
+  const_iterator end() const { return xs_.end(); }
+
+  const_iterator cbegin() const { return xs_.cbegin(); }
+
+  const_iterator cend() const { return xs_.cend(); }
+
+  /// @private
+  template <class Processor>
+  friend void serialize(Processor& proc, hash_set& x) {
+    proc & x.xs_;
+    // The table is not shipped, rebuild it from the received elements
+    if (!std::is_same<typename Processor::is_saving, std::true_type>::value) {
+      auto xs = std::move(x.xs_);
+      x.clear();
+      x.reserve(xs.size());
+      x.insert(xs.begin(), xs.end());
+    }
+  }
+
+  friend bool operator==(const hash_set& lhs, const hash_set& rhs) {
+    if (lhs.size() != rhs.size())
+      return false;
+    return std::all_of(lhs.begin(), lhs.end(),
+                       [&](const T& x) { return rhs.count(x) > 0; });
+  }
+
+  friend bool operator!=(const hash_set& lhs, const hash_set& rhs) {
+    return !(lhs == rhs);
+  }
+
+private:
+  /// Index of an element plus one, `0` marks an empty bucket
+  using index_type = uint32_t;
+
+  /// Capacity of the table after the first insert, must be a power of two
+  static constexpr size_t min_capacity = 16;
+
+  /// @returns the first bucket to probe for `x`. Mixes the hash, since
+  /// `std::hash` is the identity for integers on common implementations.
+  size_t bucket(const T& x, size_t mask) const {
+    auto h = static_cast<uint64_t>(hash_(x)) * 0x9e3779b97f4a7c15ull;
+    return static_cast<size_t>(h ^ (h >> 32)) & mask;
+  }
+
+  /// @returns the bucket of `x` or the empty bucket `x` belongs to
+  size_t probe(const T& x) const {
+    auto mask = table_.size() - 1;
+    auto pos = bucket(x, mask);
+    while (table_[pos] != 0 && !eq_(xs_[table_[pos] - 1], x))
+      pos = (pos + 1) & mask;
+    return pos;
+  }
+
+  void rehash(size_t capacity) {
+    table_.assign(capacity, 0);
+    auto mask = capacity - 1;
+    for (size_t i = 0; i < xs_.size(); ++i) {
+      auto pos = bucket(xs_[i], mask);
+      while (table_[pos] != 0)
+        pos = (pos + 1) & mask;
+      table_[pos] = static_cast<index_type>(i + 1);
+    }
+  }
+
+  std::vector<T> xs_;              /// Elements in insertion order
+  std::vector<index_type> table_;  /// Open addressing table into `xs_`
+  Hash hash_;                      /// Hash function of elements
+  Equal eq_;                       /// Equality of elements
+};
+
+template <class T, class Hash, class Equal>
+constexpr size_t hash_set<T, Hash, Equal>::min_capacity;
+
+} // namespace detail
+} // namespace crdt
+} // namespace caf
+
+#endif // CAF_CRDT_DETAIL_HASH_SET_HPP
@@ -0,0 +1,125 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_CRDT_DETAIL_LWW_STAMP_HPP
+#define CAF_CRDT_DETAIL_LWW_STAMP_HPP
+
+#include "caf/actor.hpp"
+#include "caf/node_id.hpp"
+
+#include "caf/crdt/vector_clock.hpp"
+#include "caf/crdt/hybrid_logical_clock.hpp"
+
+#include "caf/crdt/detail/digest.hpp"
+
+#include <string>
+
+namespace caf {
+namespace crdt {
+namespace detail {
+
+/// Timestamp of the current element of a `lww_register`, totally orders all
+/// writes. Specialized for each supported clock.
+template <class Clock>
+class lww_stamp;
+
+/// Orders writes by a vector clock, concurrent writes by their setter
+template <>
+class lww_stamp<vector_clock> {
+public:
+  /// Stamps a write of `setter`
+  void stamp(const actor& setter, const node_id& node,
+             const std::string& scope) {
+    clk_.increment(node, scope);
+    setter_ = setter;
+  }
+
+  /// @returns `greater`, `equal` or `smaller`, never `concurrent`
+  vector_clock_result compare(const lww_stamp& other) const {
+    auto res = clk_.compare(other.clk_);
+    if (res != concurrent)
+      return res;
+    if (setter_ == other.setter_)
+      return equal;
+    return setter_ < other.setter_ ? smaller : greater;
+  }
+
+  /// Replaces `this` with the greater stamp `other`
+  void adopt(const lww_stamp& other) {
+    *this = other;
+  }
+
+  /// @returns `true` if no write has been stamped yet
+  bool empty() const { return clk_.count() == 0; }
+
+  /// @returns a fingerprint which does not depend on the interned ids
+  uint64_t fingerprint() const {
+    return fingerprint_combine(clk_.fingerprint(),
+                               detail::fingerprint(setter_));
+  }
+
+  /// @private
+  template <class Processor>
+  friend void serialize(Processor& proc, lww_stamp& x) {
+    proc & x.clk_;
+    proc & x.setter_;
+  }
+
+private:
+  vector_clock clk_; /// Timestamp of current element
+  actor setter_;     /// Setter of current element
+};
+
+/// Orders writes by a hybrid logical clock
+template <>
+class lww_stamp<hybrid_logical_clock> {
+public:
+  /// Stamps a write on `node`
+  void stamp(const actor&, const node_id& node, const std::string&) {
+    clk_.increment(node);
+  }
+
+  /// @returns `greater`, `equal` or `smaller`
+  vector_clock_result compare(const lww_stamp& other) const {
+    return clk_.compare(other.clk_);
+  }
+
+  /// Replaces `this` with the greater stamp `other`
+  void adopt(const lww_stamp& other) {
+    clk_.merge(other.clk_);
+  }
+
+  /// @returns `true` if no write has been stamped yet
+  bool empty() const { return clk_.empty(); }
+
+  /// @private
+  template <class Processor>
+  friend void serialize(Processor& proc, lww_stamp& x) {
+    proc & x.clk_;
+  }
+
+private:
+  hybrid_logical_clock clk_; /// Timestamp of current element
+};
+
+} // namespace detail
+} // namespace crdt
+} // namespace caf
+
+#endif // CAF_CRDT_DETAIL_LWW_STAMP_HPP
@@ -0,0 +1,96 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_CRDT_DETAIL_MERGE_JOIN_HPP
+#define CAF_CRDT_DETAIL_MERGE_JOIN_HPP
+
+#include <set>
+#include <cstddef>
+
+#include "caf/crdt/detail/flat_set.hpp"
+#include "caf/crdt/detail/roaring_bitmap.hpp"
+
+namespace caf {
+namespace crdt {
+namespace detail {
+
+/// Decides whether merging `m` sorted elements into `n` sorted elements
+/// should walk both sequences (O(n + m)) or look up each of the `m` elements
+/// (O(m log n)). Full states favor the former, small deltas the latter.
+inline bool prefer_linear_merge(size_t n, size_t m) {
+  size_t log_n = 0;
+  for (auto x = n; x > 1; x >>= 1)
+    ++log_n;
+  return m * log_n >= n;
+}
+
+/// Inserts all elements of `ys` into `xs` and the elements which have been
+/// missing in `xs` into `delta`. Fallback for unordered containers.
+template <class Container>
+void merge_into(Container& xs, const Container& ys, Container& delta) {
+  for (auto& y : ys)
+    if (xs.emplace(y).second)
+      delta.insert(delta.end(), y);
+}
+
+/// Merges the ordered sets `xs` and `ys` in one pass and inserts with a
+/// hint, i.e., in amortized constant time per element.
+template <class T, class Compare, class Allocator>
+void merge_into(std::set<T, Compare, Allocator>& xs,
+                const std::set<T, Compare, Allocator>& ys,
+                std::set<T, Compare, Allocator>& delta) {
+  auto cmp = xs.key_comp();
+  auto linear = prefer_linear_merge(xs.size(), ys.size());
+  auto i = xs.begin();
+  for (auto& y : ys) {
+    if (linear) {
+      while (i != xs.end() && cmp(*i, y))
+        ++i;
+    } else {
+      i = xs.lower_bound(y);
+    }
+    if (i != xs.end() && !cmp(y, *i)) {
+      ++i;
+      continue;
+    }
+    // `i` remains valid and still points to the successor of `y`
+    xs.emplace_hint(i, y);
+    delta.emplace_hint(delta.end(), y);
+  }
+}
+
+/// Merges the sorted vectors of `xs` and `ys` in one pass
+template <class T, class Compare>
+void merge_into(flat_set<T, Compare>& xs, const flat_set<T, Compare>& ys,
+                flat_set<T, Compare>& delta) {
+  xs.merge(ys, delta);
+}
+
+/// Merges the blocks of `xs` and `ys`, see `roaring_bitmap::merge`
+template <class T>
+void merge_into(roaring_set<T>& xs, const roaring_set<T>& ys,
+                roaring_set<T>& delta) {
+  xs.merge(ys, delta);
+}
+
+} // namespace detail
+} // namespace crdt
+} // namespace caf
+
+#endif // CAF_CRDT_DETAIL_MERGE_JOIN_HPP
@@ -0,0 +1,165 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+
+#ifndef CAF_CRDT_DETAIL_RELAY_LAYER_HPP
+#define CAF_CRDT_DETAIL_RELAY_LAYER_HPP
+
+#include "caf/send.hpp"
+#include "caf/node_id.hpp"
+
+#include "caf/crdt/uri.hpp"
+#include "caf/crdt/atom_types.hpp"
+#include "caf/crdt/replicator_actor.hpp"
+
+#include "caf/crdt/detail/delta_join.hpp"
+#include "caf/crdt/detail/distribution_layer.hpp"
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <unordered_map>
+
+namespace caf {
+namespace crdt {
+namespace detail {
+
+/// Disseminates deltas along zones, e.g., racks or data centers. Nodes of
+/// the own zone receive deltas directly. Each other zone receives the deltas
+/// of a uri once, at its relay for this uri, which passes them on to the
+/// intrested nodes of its zone with its next flush. Hence a flush crosses
+/// the links between zones once per remote zone and relay instead of once
+/// per remote node. The relay of a uri is the smallest intrested node of the
+/// zone, nodes may disagree on it for a moment, which only moves the fan out
+/// to another node of the zone. Nodes without a zone receive deltas
+/// directly. Apart from the targets, this layer ships like the
+/// `distribution_layer`: batches are acknowledged, resent on reconnect and
+/// new peers receive full states, remote nodes from the relay of their zone.
+class relay_layer : public distribution_layer {
+public:
+  /// Construct a relay layer
+  /// @param joins used to coalesce buffered deltas per uri scheme
+  /// @param max_groups number of flushed delta groups retained for peers
+  /// @param label zone of the local node
+  template <class ReplicatorImpl>
+  relay_layer(ReplicatorImpl* impl, delta_join_map joins, size_t max_groups,
+              std::string label)
+      : distribution_layer(impl, std::move(joins), max_groups),
+        self_{actor_cast<actor>(impl)},
+        zone_{std::move(label)} {
+    // nop
+  }
+
+  /// Add a freshly discovered node and announce the local zone to it
+  /// @param nid node to add
+  void add_new_node(const node_id& nid) override {
+    distribution_layer::add_new_node(nid);
+    auto hdl = replicator_of(nid);
+    if (hdl)
+      send_as(self_, hdl, zone_atom::value, zone_);
+  }
+
+  /// A node is no longer reachable, the next sync elects other relays
+  /// @param nid node to remove
+  void remove_node(const node_id& nid) override {
+    distribution_layer::remove_node(nid);
+    zones_.erase(nid);
+  }
+
+  /// Ships deltas to the nodes of the own zone and to the relays of all
+  /// other zones, called whenever the intrested nodes or zones have changed
+  /// @param states local replicas
+  void sync(const state_map& states) override {
+    route_map targets;
+    route_map local;
+    for (auto& entry : directory_layer::routes()) {
+      auto& xs = targets[entry.first];
+      std::unordered_map<std::string, replicator_actor> relays;
+      for (auto& hdl : entry.second) {
+        auto label = zone_of(hdl.node());
+        if (label == nullptr || *label == zone_) {
+          xs.emplace_back(hdl);
+          if (label != nullptr)
+            local[entry.first].emplace_back(hdl);
+          continue;
+        }
+        auto& relay = relays[*label];
+        if (!relay || hdl.node() < relay.node())
+          relay = hdl;
+      }
+      for (auto& x : relays)
+        xs.emplace_back(std::move(x.second));
+    }
+    sync_.update(std::move(targets), states, local);
+  }
+
+  /// Remote nodes receive the states of this node via the relays of their
+  /// zone, which acknowledge them in their place. This layer never observes
+  /// stability at all nodes.
+  bool mark(const state_map&) override {
+    return false;
+  }
+
+  /// @private
+  bool marked(const node_id&) const override {
+    return false;
+  }
+
+  /// Records the zone of `nid`, the caller syncs afterwards
+  /// @param nid   announcing node
+  /// @param label zone of `nid`
+  void zone(const node_id& nid, const std::string& label) {
+    zones_[nid] = label;
+  }
+
+  /// Passes deltas of another zone on to the intrested nodes of this zone
+  /// with the next flush
+  /// @param nid    sending node
+  /// @param deltas deltas per uri
+  /// @returns the number of buffered deltas
+  size_t pass_on(const node_id& nid, const delta_batch& deltas) {
+    auto label = zone_of(nid);
+    if (label == nullptr || *label == zone_)
+      return 0;
+    size_t result = 0;
+    for (auto& entry : deltas)
+      for (auto& msg : entry.second) {
+        sync_.pass_on(entry.first, msg);
+        ++result;
+      }
+    return result;
+  }
+
+private:
+  /// @returns the zone of `nid` or `nullptr` if `nid` has not announced one
+  const std::string* zone_of(const node_id& nid) const {
+    auto iter = zones_.find(nid);
+    return iter != zones_.end() ? &iter->second : nullptr;
+  }
+
+  actor self_;                    /// Sender of all messages
+  std::string zone_;              /// Zone of the local node
+  std::unordered_map<node_id, std::string> zones_; /// Zones of remote nodes
+};
+
+} // namespace detail
+} // namespace crdt
+} // namespace caf
+
+#endif // CAF_CRDT_DETAIL_RELAY_LAYER_HPP
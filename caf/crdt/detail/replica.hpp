@@ -20,6 +20,8 @@
 #ifndef CAF_CRDT_DETAIL_REPLICA_HPP
 #define CAF_CRDT_DETAIL_REPLICA_HPP
 
+#include "caf/send.hpp"
+#include "caf/actor_registry.hpp"
 #include "caf/event_based_actor.hpp"
 
 #include "caf/crdt/uri.hpp"
@@ -27,6 +29,11 @@
 #include "caf/crdt/notifiable.hpp"
 #include "caf/crdt/replicator_actor.hpp"
 
+#include "caf/crdt/detail/digest.hpp"
+#include "caf/crdt/detail/adaptive_notify.hpp"
+
+#include <vector>
+#include <cstdint>
 #include <unordered_set>
 
 namespace caf {
@@ -136,15 +143,28 @@ behavior reader(stateful_actor<wr_state<T>>* self) {
 template <class T>
 class replica : public event_based_actor {
 public:
-  replica(actor_config& cfg, const uri& id, size_t notify_interval_ms)
+  /// Mailbox backlog counted per notification at most
+  static constexpr size_t max_backlog = 1024;
+
+  /// @param notify_interval_ms interval of notifications
+  /// @param notify_min_ms lower bound of an adaptive interval
+  /// @param notify_max_ms upper bound of an adaptive interval, `0` fixes the
+  ///                      interval to `notify_interval_ms`
+  replica(actor_config& cfg, const uri& id, size_t notify_interval_ms,
+          size_t notify_min_ms, size_t notify_max_ms)
       : event_based_actor(cfg), id_{id},
-        notify_interval_ms_{notify_interval_ms} {
+        notify_{std::chrono::milliseconds(notify_interval_ms),
+                std::chrono::milliseconds(notify_min_ms),
+                std::chrono::milliseconds(notify_max_ms)} {
     // nop
   }
 
 protected:
   behavior make_behavior() override {
-    send(this, notify_atom::value);
+    // All replicas of a node share the timer wheel of the replicator
+    wheel_ = actor_cast<actor>(system().registry().get(wheel_atom::value));
+    if (notify_.enabled())
+      report();
     auto unpack = [&](message& msg) {
       T unpacked;
       msg.apply([&](T& t) { unpacked = std::move(t); });
@@ -156,6 +176,8 @@ protected:
         if (delta.empty())
           return; // State was already included
         buffer_.merge(delta);
+        notify_.merged();
+        arm();
       },
       [&](publish_atom, std::vector<message>& msgs) {
         T delta;
@@ -165,16 +187,19 @@ protected:
         if (delta.empty())
           return; // State was already included
         buffer_.merge(delta);
+        notify_.merged(msgs.size());
+        arm();
       },
       [&](notify_atom) {
+        armed_ = false;
         if (!buffer_.empty()) {
           auto msg = make_message(notify_atom::value, buffer_);
           for (auto& sub : subs_)
             send(sub, msg);
           buffer_ = {}; // reset buffer
         }
-        delayed_send(this, std::chrono::milliseconds(notify_interval_ms_),
-                     notify_atom::value);
+        if (notify_.notified(subs_.size(), mailbox().count(max_backlog)))
+          report();
       },
       [&](subscribe_atom) {
         auto handle = actor_cast<actor>(current_sender());
@@ -194,6 +219,25 @@ protected:
         send(system().replicator().actor_handle(),
              copy_ack_atom::value, id_, make_message(cvrdt_));
       },
+      // -- Digest reconciliation, replicas descend into differing ranges
+      [&](digest_atom, const std::vector<replicator_actor>& peers) {
+        auto root = digest_root(cvrdt_);
+        for (auto& peer : peers)
+          send(peer, digest_atom::value, id_, root);
+      },
+      [&](digest_atom, uint64_t root) {
+        descend({0}, {root});
+      },
+      [&](digest_atom, const std::vector<digest_range>& ranges,
+          const std::vector<uint64_t>& hashes) {
+        descend(ranges, hashes);
+      },
+      [&](reconcile_atom, const std::vector<digest_range>& ranges) {
+        auto part = slice_of(cvrdt_, ranges);
+        if (!part.empty())
+          send(actor_cast<actor>(current_sender()), publish_atom::value,
+               make_message(std::move(part)));
+      },
       [&](read_all_atom, const uri& u, std::set<replicator_actor> from) {
         from.emplace(this->system().replicator().actor_handle());
         delegate(this->spawn(reader<T>), read_all_atom::value, u,
@@ -236,17 +280,67 @@ protected:
       },
       [&](delete_replica) {
         if (subs_.size()) return;
+        if (notify_.enabled())
+          system().replicator().notify_intervals().erase(id_);
+        quit();
+      },
+      [&](delete_replica, const replicator_actor& heir) {
+        // The uri has moved to the node of `heir`, subscribers follow it
+        for (auto& sub : subs_)
+          send_as(sub, heir, subscribe_atom::value, id_);
+        subs_.clear();
+        if (notify_.enabled())
+          system().replicator().notify_intervals().erase(id_);
         quit();
       }
     };
   }
 
 private:
+  /// Schedules a notification once the delta-buffer is non-empty, idle
+  /// replicas have no timer at all
+  void arm() {
+    if (armed_)
+      return;
+    armed_ = true;
+    auto interval = notify_.interval();
+    if (wheel_)
+      send(wheel_, notify_atom::value, static_cast<size_t>(interval.count()));
+    else
+      delayed_send(this, interval, notify_atom::value);
+  }
+
+  /// Reports the current notify interval as metric
+  void report() {
+    system().replicator().notify_intervals().record(
+      id_, static_cast<size_t>(notify_.interval().count()));
+  }
+
+  /// Compares `ranges` with the `hashes` of the sending replica, exchanges
+  /// small differing ranges and asks the sender to compare the children of
+  /// large ones
+  void descend(const std::vector<digest_range>& ranges,
+               const std::vector<uint64_t>& hashes) {
+    auto step = digest_compare(cvrdt_, ranges, hashes);
+    auto peer = actor_cast<actor>(current_sender());
+    if (!step.resolved.empty()) {
+      auto part = slice_of(cvrdt_, step.resolved);
+      if (!part.empty())
+        send(peer, publish_atom::value, make_message(std::move(part)));
+      send(peer, reconcile_atom::value, std::move(step.resolved));
+    }
+    if (!step.split.empty())
+      send(peer, digest_atom::value, std::move(step.split),
+           std::move(step.hashes));
+  }
+
   T cvrdt_;                        /// CRDT State (complete state)
   T buffer_;                       /// delta-Buffer for subscribers
   uri id_;                         /// Replic-ID
-  size_t notify_interval_ms_;      /// Notify interval
+  adaptive_notify notify_;         /// Chooses the notify interval
   std::unordered_set<actor> subs_; /// Subscribers
+  actor wheel_;                    /// Timer wheel of this node
+  bool armed_ = false;             /// A notification is scheduled
 };
 
 } // namespace detail
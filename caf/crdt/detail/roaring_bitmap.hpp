@@ -0,0 +1,364 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_CRDT_DETAIL_ROARING_BITMAP_HPP
+#define CAF_CRDT_DETAIL_ROARING_BITMAP_HPP
+
+#include <limits>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <iterator>
+#include <type_traits>
+#include <initializer_list>
+
+namespace caf {
+namespace crdt {
+namespace detail {
+
+/// Compressed bitmap of 64 bit integers following the roaring bitmap layout.
+/// Values are partitioned by their upper 48 bits into blocks of 2^16 values,
+/// each block stores the lower 16 bits in the cheapest container:
+///  - array: sorted values, for blocks with at most 4096 values
+///  - bitmap: 1024 words, for dense blocks
+///  - run: sorted `[start, start + length]` pairs, for clustered values
+/// Run containers are only created by `optimize` and on the wire, where
+/// serialization ships the cheapest representation of each block without
+/// converting the bitmap itself. Mutating a run container converts it first.
+class roaring_bitmap {
+public:
+  /// @private
+  enum block_type : uint8_t {
+    array_block,
+    bitmap_block,
+    run_block
+  };
+
+  /// @private
+  struct block {
+    uint64_t key = 0;               /// Upper 48 bits of all values
+    uint8_t type = array_block;     /// A `block_type`
+    uint32_t card = 0;              /// Number of values
+    std::vector<uint16_t> values;   /// Sorted values or run pairs
+    std::vector<uint64_t> bits;     /// Words of a bitmap container
+
+    /// @private
+    template <class Processor>
+    friend void serialize(Processor& proc, block& x) {
+      proc & x.key;
+      proc & x.type;
+      proc & x.values;
+      proc & x.bits;
+    }
+  };
+
+  /// Iterates all values in ascending order
+  class const_iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = uint64_t;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const uint64_t*;
+    using reference = const uint64_t&;
+
+    const_iterator() = default;
+
+    const uint64_t& operator*() const { return value_; }
+
+    const uint64_t* operator->() const { return &value_; }
+
+    const_iterator& operator++() {
+      parent_->advance(*this);
+      return *this;
+    }
+
+    const_iterator operator++(int) {
+      auto result = *this;
+      ++*this;
+      return result;
+    }
+
+    friend bool operator==(const const_iterator& lhs,
+                           const const_iterator& rhs) {
+      return lhs.block_ == rhs.block_ && lhs.pos_ == rhs.pos_
+             && lhs.low_ == rhs.low_;
+    }
+
+    friend bool operator!=(const const_iterator& lhs,
+                           const const_iterator& rhs) {
+      return !(lhs == rhs);
+    }
+
+  private:
+    friend class roaring_bitmap;
+
+    const roaring_bitmap* parent_ = nullptr; /// Iterated bitmap
+    size_t block_ = 0;  /// Index of the current block
+    uint32_t pos_ = 0;  /// Array index, bitmap value or run index
+    uint32_t low_ = 0;  /// Current value inside of a run
+    uint64_t value_ = 0;
+  };
+
+  using value_type = uint64_t;
+
+  /// Adds `x` to the bitmap
+  /// @returns `true` if `x` has been added, `false` if it was present
+  bool add(uint64_t x);
+
+  /// @returns `true` if `x` is in the bitmap
+  bool contains(uint64_t x) const;
+
+  /// @returns an iterator to `x` or `end()`
+  const_iterator find(uint64_t x) const;
+
+  /// Adds all values of `other` to `this` and stores the values which have
+  /// been missing in `this` in `delta`. Bitmap containers are merged by
+  /// vectorized `or` and `andnot` kernels.
+  void merge(const roaring_bitmap& other, roaring_bitmap& delta);
+
+  /// Converts each container to its cheapest representation
+  void optimize();
+
+  /// @returns the number of values
+  inline size_t size() const { return size_; }
+
+  /// @returns `true` if the bitmap holds no values
+  inline bool empty() const { return size_ == 0; }
+
+  /// Removes all values
+  void clear();
+
+  const_iterator begin() const;
+
+  const_iterator end() const;
+
+  /// @private
+  template <class Processor>
+  friend void serialize(Processor& proc, roaring_bitmap& x) {
+    x.serialize_impl(proc, typename Processor::is_saving{});
+  }
+
+  friend bool operator==(const roaring_bitmap& lhs, const roaring_bitmap& rhs);
+
+  friend bool operator<(const roaring_bitmap& lhs, const roaring_bitmap& rhs);
+
+private:
+  /// @private
+  template <class Processor>
+  void serialize_impl(Processor& proc, std::true_type) {
+    auto xs = optimized();
+    proc & xs;
+  }
+
+  /// @private
+  template <class Processor>
+  void serialize_impl(Processor& proc, std::false_type) {
+    proc & blocks_;
+    repair();
+  }
+
+  /// Restores all invariants after loading untrusted blocks
+  void repair();
+
+  /// @returns a copy of all blocks in their cheapest representation
+  std::vector<block> optimized() const;
+
+  /// Positions `it` at the first value of its block or the next block
+  void enter(const_iterator& it) const;
+
+  /// Positions `it` at the next value
+  void advance(const_iterator& it) const;
+
+  /// Skips to the next value at or after the position of `it`
+  void seek(const_iterator& it) const;
+
+  std::vector<block> blocks_; /// Non-empty blocks sorted by key
+  size_t size_ = 0;           /// Number of values in all blocks
+};
+
+/// Set of integers stored in a `roaring_bitmap`. Maps signed integers to
+/// unsigned keys preserving their order, hence the set iterates in order.
+template <class T>
+class roaring_set {
+  static_assert(std::is_integral<T>::value, "roaring_set requires integers");
+
+public:
+  using value_type = T;
+  using key_type = T;
+  using size_type = size_t;
+
+  /// Iterates all elements in ascending order
+  class const_iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const T*;
+    using reference = const T&;
+
+    const_iterator() = default;
+
+    explicit const_iterator(roaring_bitmap::const_iterator i,
+                            roaring_bitmap::const_iterator last)
+        : i_(i) {
+      if (i_ != last)
+        value_ = decode(*i_);
+    }
+
+    const T& operator*() const { return value_; }
+
+    const T* operator->() const { return &value_; }
+
+    const_iterator& operator++() {
+      // The end iterator never gets dereferenced, decoding it is harmless
+      value_ = decode(*++i_);
+      return *this;
+    }
+
+    const_iterator operator++(int) {
+      auto result = *this;
+      ++*this;
+      return result;
+    }
+
+    friend bool operator==(const const_iterator& lhs,
+                           const const_iterator& rhs) {
+      return lhs.i_ == rhs.i_;
+    }
+
+    friend bool operator!=(const const_iterator& lhs,
+                           const const_iterator& rhs) {
+      return lhs.i_ != rhs.i_;
+    }
+
+  private:
+    roaring_bitmap::const_iterator i_;
+    T value_ = 0;
+  };
+
+  using iterator = const_iterator;
+
+  roaring_set() = default;
+
+  roaring_set(std::initializer_list<T> xs) {
+    insert(xs.begin(), xs.end());
+  }
+
+  /// Inserts `x` if it is not in the set yet
+  /// @returns an iterator to `x` and `true` if `x` has been inserted
+  std::pair<iterator, bool> emplace(const T& x) {
+    auto added = bits_.add(encode(x));
+    return {find(x), added};
+  }
+
+  /// Inserts `x` if it is not in the set yet, `hint` is ignored
+  iterator insert(const_iterator, const T& x) {
+    return emplace(x).first;
+  }
+
+  /// Inserts all elements of the range `[first, last)`
+  template <class Iterator>
+  void insert(Iterator first, Iterator last) {
+    for (; first != last; ++first)
+      bits_.add(encode(*first));
+  }
+
+  /// @returns an iterator to `x` or `end()`
+  const_iterator find(const T& x) const {
+    return const_iterator{bits_.find(encode(x)), bits_.end()};
+  }
+
+  /// @returns `1` if `x` is in the set, `0` otherwise
+  size_t count(const T& x) const {
+    return bits_.contains(encode(x)) ? 1 : 0;
+  }
+
+  /// Inserts all elements of `other` and stores the elements which have
+  /// been missing in `this` in `delta`
+  void merge(const roaring_set& other, roaring_set& delta) {
+    bits_.merge(other.bits_, delta.bits_);
+  }
+
+  void clear() { bits_.clear(); }
+
+  size_t size() const { return bits_.size(); }
+
+  bool empty() const { return bits_.empty(); }
+
+  const_iterator begin() const {
+    return const_iterator{bits_.begin(), bits_.end()};
+  }
+
+  const_iterator end() const {
+    return const_iterator{bits_.end(), bits_.end()};
+  }
+
+  const_iterator cbegin() const { return begin(); }
+
+  const_iterator cend() const { return end(); }
+
+  /// @private
+  template <class Processor>
+  friend void serialize(Processor& proc, roaring_set& x) {
+    proc & x.bits_;
+  }
+
+  friend bool operator==(const roaring_set& lhs, const roaring_set& rhs) {
+    return lhs.bits_ == rhs.bits_;
+  }
+
+  friend bool operator!=(const roaring_set& lhs, const roaring_set& rhs) {
+    return !(lhs.bits_ == rhs.bits_);
+  }
+
+  friend bool operator<(const roaring_set& lhs, const roaring_set& rhs) {
+    return lhs.bits_ < rhs.bits_;
+  }
+
+private:
+  using unsigned_type = typename std::make_unsigned<T>::type;
+
+  /// Flipping the sign bit maps signed order to unsigned order
+  static constexpr unsigned_type sign_bit =
+    std::is_signed<T>::value
+    ? static_cast<unsigned_type>(unsigned_type{1}
+                                 << (std::numeric_limits<unsigned_type>::digits
+                                     - 1))
+    : unsigned_type{0};
+
+  static uint64_t encode(T x) {
+    return static_cast<uint64_t>(static_cast<unsigned_type>(x) ^ sign_bit);
+  }
+
+  static T decode(uint64_t x) {
+    return static_cast<T>(static_cast<unsigned_type>(x) ^ sign_bit);
+  }
+
+  roaring_bitmap bits_; /// Encoded elements
+};
+
+template <class T>
+constexpr typename roaring_set<T>::unsigned_type roaring_set<T>::sign_bit;
+
+} // namespace detail
+} // namespace crdt
+} // namespace caf
+
+#endif // CAF_CRDT_DETAIL_ROARING_BITMAP_HPP
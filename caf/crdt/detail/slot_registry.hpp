@@ -0,0 +1,142 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_CRDT_DETAIL_SLOT_REGISTRY_HPP
+#define CAF_CRDT_DETAIL_SLOT_REGISTRY_HPP
+
+#include "caf/fwd.hpp"
+#include "caf/node_id.hpp"
+
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace caf {
+namespace crdt {
+namespace detail {
+
+/// Interns clock slots to small integer ids. A slot is identified by the node
+/// and the id of the actor owning it, the mapping is process-wide and never
+/// shrinks. Ids are only valid inside this process and must not be shipped.
+/// Slots of a node as a whole use the actor id `0`. Ids and counters never
+/// move, each thread caches the ones it has seen and looks them up again
+/// without taking the lock.
+class slot_registry {
+public:
+  /// Dense id of an interned slot
+  using slot_id = uint32_t;
+
+  /// Unique key of a slot
+  using key_type = std::pair<node_id, actor_id>;
+
+  /// @returns the process-wide registry
+  static slot_registry& instance();
+
+  /// Returns the id of `key`, interns `key` if it is not known yet
+  slot_id intern(const key_type& key);
+
+  /// Returns the id of the slot for `node` as a whole
+  inline slot_id intern(const node_id& node) {
+    return intern(key_type{node, actor_id{0}});
+  }
+
+  /// Returns the next event counter for `slot` and `scope`. Counters start
+  /// at 1 and are unique and gapless per slot and scope in this process.
+  uint64_t next_counter(slot_id slot, const std::string& scope);
+
+  /// Adds `n` to the counter for `slot` and `scope`
+  /// @returns the new value of the counter
+  uint64_t add_counter(slot_id slot, const std::string& scope, uint64_t n);
+
+  /// Looks up `key` without interning it
+  /// @param key slot to look up
+  /// @param result set to the id of `key` if `key` is known
+  /// @returns `true` if `key` is known, `false` otherwise
+  bool find(const key_type& key, slot_id& result) const;
+
+  /// @returns the key of `id`
+  key_type key(slot_id id) const;
+
+  /// Resolves `n` ids starting at `first` and appends their keys to `out`
+  void keys(const slot_id* first, size_t n, std::vector<key_type>& out) const;
+
+  /// Interns `n` keys starting at `first` and appends their ids to `out`
+  void intern(const key_type* first, size_t n, std::vector<slot_id>& out);
+
+  /// Retires all slots of `node`. Clocks and counters drop or fold retired
+  /// slots the next time they are merged, causal contexts keep them. Should
+  /// only be called once the slots of `node` are causally stable, i.e., every
+  /// live replica has seen them. The replicator retires a lost node once all
+  /// live peers and this node have acknowledged each other's full states
+  /// since losing it, updates of `node` arriving later are lost.
+  void retire(const node_id& node);
+
+  /// @returns `true` if `node` has been retired
+  bool retired(const node_id& node) const;
+
+  /// @returns the sorted ids of all retired slots
+  std::shared_ptr<const std::vector<slot_id>> retired_slots() const;
+
+  /// @returns a number that changes whenever a node is retired
+  inline uint64_t generation() const {
+    return generation_.load(std::memory_order_acquire);
+  }
+
+private:
+  slot_registry() = default;
+
+  /// @private
+  struct key_hash {
+    size_t operator()(const key_type& x) const {
+      auto h = std::hash<node_id>{}(x.first);
+      return h ^ (std::hash<actor_id>{}(x.second) + 0x9e3779b9
+                  + (h << 6) + (h >> 2));
+    }
+  };
+
+  /// @private
+  slot_id unsafe_intern(const key_type& key);
+
+  /// @returns the counter for `slot` and `scope`, its address is stable
+  std::atomic<uint64_t>& counter(slot_id slot, const std::string& scope);
+
+  /// @private
+  using counter_map =
+    std::unordered_map<std::string, std::atomic<uint64_t>>;
+
+  mutable std::mutex mtx_;                           /// Guards all members
+  std::unordered_map<key_type, slot_id, key_hash> ids_; /// Key => id
+  std::vector<key_type> keys_;                       /// Id => key
+  std::unordered_map<slot_id, counter_map> counters_;   /// Event counters
+  std::unordered_set<node_id> retired_nodes_;        /// Retired nodes
+  std::shared_ptr<const std::vector<slot_id>> retired_slots_; /// Sorted
+  std::atomic<uint64_t> generation_{0};              /// Retire generation
+};
+
+} // namespace detail
+} // namespace crdt
+} // namespace caf
+
+#endif // CAF_CRDT_DETAIL_SLOT_REGISTRY_HPP
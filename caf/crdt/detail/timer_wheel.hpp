@@ -0,0 +1,135 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+
+#ifndef CAF_CRDT_DETAIL_TIMER_WHEEL_HPP
+#define CAF_CRDT_DETAIL_TIMER_WHEEL_HPP
+
+#include "caf/actor.hpp"
+#include "caf/behavior.hpp"
+#include "caf/stateful_actor.hpp"
+
+#include <array>
+#include <chrono>
+#include <limits>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+namespace caf {
+namespace crdt {
+namespace detail {
+
+/// Hierarchical timer wheel. Level `l` holds 64 slots of 64^l ticks each,
+/// a timer is placed on the lowest level whose slot range contains its
+/// deadline and cascades to lower levels while time advances. Scheduling
+/// and expiring a timer is O(1) and an idle wheel costs nothing, since
+/// `next_expiry` lets its owner sleep until the next occupied slot.
+class timer_wheel {
+public:
+  /// Slots per level
+  static constexpr size_t slots = 64;
+
+  /// Levels, enough to cover all 64-bit deadlines
+  static constexpr size_t levels = 11;
+
+  /// Returned by `next_expiry` if no timer is scheduled
+  static constexpr uint64_t never = std::numeric_limits<uint64_t>::max();
+
+  timer_wheel();
+
+  /// Schedules a timer for `target`, which expires `delay` ticks from now.
+  /// Timers expire at least one tick from now.
+  void schedule(uint64_t delay, actor target);
+
+  /// Advances the wheel to tick `to` and calls `f` with the target of each
+  /// expired timer
+  template <class F>
+  void advance(uint64_t to, F f) {
+    while (now_ < to && size_ > 0) {
+      // Skip ticks without expiring or cascading timers
+      auto step = next_expiry();
+      if (step > to - now_)
+        break;
+      now_ += step;
+      cascade();
+      auto& slot = wheel_[0][now_ % slots];
+      if (slot.empty())
+        continue;
+      occupied_[0] &= ~(uint64_t{1} << (now_ % slots));
+      auto expired = std::move(slot);
+      slot.clear();
+      size_ -= expired.size();
+      for (auto& x : expired)
+        f(x.target);
+    }
+    now_ = std::max(now_, to);
+  }
+
+  /// @returns the ticks until the wheel has to advance next or `never`
+  uint64_t next_expiry() const;
+
+  /// @returns the current tick
+  inline uint64_t now() const { return now_; }
+
+  /// @returns the number of scheduled timers
+  inline size_t size() const { return size_; }
+
+  /// @returns `true` if no timer is scheduled
+  inline bool empty() const { return size_ == 0; }
+
+private:
+  /// @private
+  struct entry {
+    uint64_t deadline;
+    actor target;
+  };
+
+  /// Puts `x` in the slot of the lowest level covering its deadline
+  void insert(entry x);
+
+  /// Moves the timers of the slots which start at the current tick to
+  /// lower levels
+  void cascade();
+
+  uint64_t now_;                                  /// Current tick
+  size_t size_;                                   /// Scheduled timers
+  std::array<uint64_t, levels> occupied_;         /// Non-empty slots
+  std::array<std::array<std::vector<entry>, slots>, levels> wheel_; /// Slots
+};
+
+/// State of the notify wheel of a node
+struct notify_wheel_state {
+  timer_wheel wheel;                              /// Pending notifications
+  std::chrono::steady_clock::time_point start;    /// Tick 0
+  uint64_t wake = timer_wheel::never;             /// Next scheduled tick
+  static const char* name;
+};
+
+/// Delivers `notify_atom` to replicas when their notify interval is over.
+/// A replica arms its notification with `(notify_atom, delay_ms)` once its
+/// delta-buffer becomes non-empty, all replicas of a node share this actor,
+/// which only wakes up if a notification is due.
+behavior notify_wheel(stateful_actor<notify_wheel_state>* self);
+
+} // namespace detail
+} // namespace crdt
+} // namespace caf
+
+#endif // CAF_CRDT_DETAIL_TIMER_WHEEL_HPP
@@ -0,0 +1,64 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_CRDT_DETAIL_URI_REGISTRY_HPP
+#define CAF_CRDT_DETAIL_URI_REGISTRY_HPP
+
+#include "caf/crdt/uri.hpp"
+
+#include <mutex>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+
+namespace caf {
+namespace crdt {
+namespace detail {
+
+/// Interns uris to 32-bit ids. The mapping is process-wide and never
+/// shrinks. Ids are shipped instead of uris, each node announces the uri of
+/// an id to a peer along with the first batch which uses the id. Rumors are
+/// not acknowledged and announce all of their ids.
+class uri_registry {
+public:
+  /// Dense id of an interned uri
+  using uri_id = uint32_t;
+
+  /// @returns the process-wide registry
+  static uri_registry& instance();
+
+  /// Returns the id of `x`, interns `x` if it is not known yet
+  uri_id intern(const uri& x);
+
+  /// @returns the uri of `id`
+  uri get(uri_id id) const;
+
+private:
+  uri_registry() = default;
+
+  mutable std::mutex mtx_;                  /// Guards all members
+  std::unordered_map<uri, uri_id> ids_;     /// Uri => id
+  std::vector<uri> uris_;                   /// Id => uri
+};
+
+} // namespace detail
+} // namespace crdt
+} // namespace caf
+
+#endif // CAF_CRDT_DETAIL_URI_REGISTRY_HPP
@@ -0,0 +1,60 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+#ifndef CAF_CRDT_DETAIL_WIRE_ENCODER_HPP
+#define CAF_CRDT_DETAIL_WIRE_ENCODER_HPP
+
+#include "caf/crdt/replicator_actor.hpp"
+
+#include "caf/crdt/detail/uri_registry.hpp"
+
+namespace caf {
+namespace crdt {
+namespace detail {
+
+/// Encodes batches for layers which ship deltas without `anti_entropy`.
+/// Entries are keyed by interned ids. These batches are not acknowledged and
+/// may get lost, hence each of them announces the uris of all its ids.
+class wire_encoder {
+public:
+  /// @returns `xs` keyed by interned ids
+  static wire_batch encode(const delta_batch& xs) {
+    wire_batch result;
+    result.reserve(xs.size());
+    auto& reg = uri_registry::instance();
+    for (auto& entry : xs)
+      result.emplace_back(reg.intern(entry.first), entry.second);
+    return result;
+  }
+
+  /// @returns the uris of all ids in `xs`
+  static uri_dictionary announce(const wire_batch& xs) {
+    uri_dictionary result;
+    result.reserve(xs.size());
+    auto& reg = uri_registry::instance();
+    for (auto& entry : xs)
+      result.emplace_back(entry.first, reg.get(entry.first));
+    return result;
+  }
+};
+
+} // namespace detail
+} // namespace crdt
+} // namespace caf
+
+#endif // CAF_CRDT_DETAIL_WIRE_ENCODER_HPP
@@ -0,0 +1,195 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_CRDT_DOTTED_VERSION_VECTOR_HPP
+#define CAF_CRDT_DOTTED_VERSION_VECTOR_HPP
+
+#include "caf/node_id.hpp"
+
+#include "caf/crdt/vector_clock.hpp"
+
+#include "caf/crdt/detail/slot_registry.hpp"
+
+#include <string>
+#include <vector>
+#include <type_traits>
+
+namespace caf {
+namespace crdt {
+
+/// A single event, the `counter`-th event of a node slot.
+/// @relates `causal_context`
+class dot {
+  /// Interned id of a slot
+  using slot_id = detail::slot_registry::slot_id;
+
+public:
+  dot() = default;
+
+  dot(slot_id slot, uint64_t counter) : slot_{slot}, counter_{counter} {
+    // nop
+  }
+
+  /// @returns the interned slot of this event
+  inline slot_id slot() const { return slot_; }
+
+  /// @returns the counter of this event
+  inline uint64_t counter() const { return counter_; }
+
+  /// @private
+  template <class Processor>
+  friend void serialize(Processor& proc, dot& x) {
+    x.serialize_impl(proc, typename Processor::is_saving{});
+  }
+
+  /// @private
+  friend bool operator==(const dot& lhs, const dot& rhs) {
+    return lhs.slot_ == rhs.slot_ && lhs.counter_ == rhs.counter_;
+  }
+
+  /// @private
+  friend bool operator<(const dot& lhs, const dot& rhs) {
+    return lhs.slot_ < rhs.slot_
+           || (lhs.slot_ == rhs.slot_ && lhs.counter_ < rhs.counter_);
+  }
+
+private:
+  /// @private
+  template <class Processor>
+  void serialize_impl(Processor& proc, std::true_type) {
+    auto key = detail::slot_registry::instance().key(slot_);
+    proc & key.first;
+    proc & counter_;
+  }
+
+  /// @private
+  template <class Processor>
+  void serialize_impl(Processor& proc, std::false_type) {
+    node_id node;
+    proc & node;
+    proc & counter_;
+    slot_ = detail::slot_registry::instance().intern(node);
+  }
+
+  slot_id slot_ = 0;     /// Node slot of this event
+  uint64_t counter_ = 0; /// Sequence number of this event
+};
+
+/// Set of events seen by a replica. Events are stored as a gapless prefix per
+/// node slot plus a sorted cloud of events beyond that prefix, which allows
+/// to track events that are received out of order. Once the gaps are filled,
+/// the cloud is folded into the prefix again. Unlike clocks, contexts keep
+/// the prefix of retired nodes, i.e., one slot per node ever seen, since
+/// values of these nodes could neither be overwritten nor told apart from
+/// unseen ones otherwise.
+class causal_context {
+public:
+  /// Creates a new event of `node` and adds it to this context
+  /// @param node node that creates the event
+  /// @param scope scope of the event counter, usually a replica id
+  /// @returns the new event
+  dot next(const node_id& node, const std::string& scope);
+
+  /// @returns `true` if `x` is part of this context
+  bool contains(const dot& x) const;
+
+  /// Adds `x` to this context
+  void insert(const dot& x);
+
+  /// Merges `other` into `this`
+  /// @returns `true` if `this` has changed
+  bool merge(const causal_context& other);
+
+  /// @returns `true` if this context holds no events
+  inline bool empty() const { return vv_.count() == 0 && cloud_.empty(); }
+
+  /// @returns a fingerprint which does not depend on the interned ids
+  uint64_t fingerprint() const;
+
+  /// @private
+  template <class Processor>
+  friend void serialize(Processor& proc, causal_context& x) {
+    proc & x.vv_;
+    proc & x.cloud_;
+    // Interned ids differ between processes, restore the order after loading
+    if (!Processor::is_saving::value)
+      x.compact(true);
+  }
+
+private:
+  /// Folds the cloud into the prefix where possible
+  /// @param sort restores the order of the cloud first
+  void compact(bool sort = false);
+
+  vector_clock vv_;        /// Gapless prefix of events per node slot
+  std::vector<dot> cloud_; /// Sorted events beyond the prefix
+};
+
+/// Dotted version vector, an event together with the causal context it was
+/// created in. Unlike vector clocks with one slot per writing actor, the
+/// size is bounded by the number of nodes while concurrent writes on the same
+/// node remain distinguishable.
+class dotted_version_vector {
+public:
+  dotted_version_vector() = default;
+
+  dotted_version_vector(causal_context context, dot event)
+    : context_{std::move(context)}, event_{event} {
+    // nop
+  }
+
+  /// @returns the event of this version
+  inline const dot& event() const { return event_; }
+
+  /// @returns the causal context of this version
+  inline const causal_context& context() const { return context_; }
+
+  /// Compare two versions, the semantics match `vector_clock::compare`
+  /// @param other version to compare to
+  /// @returns `greater` if `this` has seen the event of `other`,
+  ///          `smaller` if `other` has seen the event of `this`,
+  ///          `equal` if both share the same event,
+  ///          `concurrent` otherwise
+  vector_clock_result compare(const dotted_version_vector& other) const;
+
+  /// @returns a fingerprint which does not depend on the interned ids
+  uint64_t fingerprint() const;
+
+  /// @private
+  template <class Processor>
+  friend void serialize(Processor& proc, dotted_version_vector& x) {
+    proc & x.context_;
+    proc & x.event_;
+  }
+
+  /// @private
+  friend bool operator<(const dotted_version_vector& lhs,
+                        const dotted_version_vector& rhs) {
+    return lhs.event_ < rhs.event_;
+  }
+
+private:
+  causal_context context_; /// Events seen by the writer
+  dot event_;              /// Event of the write
+};
+
+} // namespace crdt
+} // namespace caf
+
+#endif // CAF_CRDT_DOTTED_VERSION_VECTOR_HPP
@@ -0,0 +1,65 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_CRDT_FLUSH_METRICS_HPP
+#define CAF_CRDT_FLUSH_METRICS_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace caf {
+namespace crdt {
+
+/// Triggers of a buffer flush
+enum class flush_trigger {
+  size,  /// Buffered deltas crossed `crdt_flush_max_deltas`
+  delay, /// Oldest buffered delta waited for the max delay
+  idle,  /// No delta has been buffered within the idle interval
+  forced /// Explicit flush, e.g., on shutdown
+};
+
+/// Counts the flushes of the replicator and its shards per trigger
+class flush_metrics {
+public:
+  /// Records a flush of `deltas` buffered deltas fired by `x`
+  inline void record(flush_trigger x, uint64_t deltas) {
+    counters_[static_cast<size_t>(x)].fetch_add(1, std::memory_order_relaxed);
+    deltas_.fetch_add(deltas, std::memory_order_relaxed);
+  }
+
+  /// @returns the number of flushes fired by `x`
+  inline uint64_t flushes(flush_trigger x) const {
+    return counters_[static_cast<size_t>(x)].load(std::memory_order_relaxed);
+  }
+
+  /// @returns the number of deltas flushed in total
+  inline uint64_t deltas() const {
+    return deltas_.load(std::memory_order_relaxed);
+  }
+
+private:
+  std::atomic<uint64_t> counters_[4] = {}; /// Flushes per trigger
+  std::atomic<uint64_t> deltas_{0};        /// Flushed deltas
+};
+
+} // namespace crdt
+} // namespace caf
+
+#endif // CAF_CRDT_FLUSH_METRICS_HPP
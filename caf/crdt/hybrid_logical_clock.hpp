@@ -0,0 +1,96 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_CRDT_HYBRID_LOGICAL_CLOCK_HPP
+#define CAF_CRDT_HYBRID_LOGICAL_CLOCK_HPP
+
+#include "caf/node_id.hpp"
+
+#include "caf/crdt/vector_clock.hpp"
+
+#include <cstdint>
+
+namespace caf {
+namespace crdt {
+
+/// Hybrid logical clock (HLC) for totally ordering events. The upper 48 bits
+/// of the timestamp hold the physical time in milliseconds, the lower 16 bits
+/// a logical counter. Timestamps are made unique by a hash of the issuing
+/// node, which breaks ties between nodes. A clock has a fixed size of 16
+/// bytes and compares in constant time, but unlike `vector_clock` it cannot
+/// detect concurrent events.
+class hybrid_logical_clock {
+public:
+  /// Default constructor
+  hybrid_logical_clock() = default;
+
+  /// @private
+  hybrid_logical_clock(uint64_t time, uint64_t node)
+    : time_{time}, node_{node} {
+    // nop
+  }
+
+  /// Advances the clock for a local event on `node`. The new timestamp is
+  /// greater than any timestamp issued or observed in this process.
+  /// @param node issuing node of the event
+  /// @returns the new timestamp
+  hybrid_logical_clock increment(const node_id& node);
+
+  /// Compares two timestamps, first by time and then by node
+  /// @param other `hybrid_logical_clock` to compare to
+  /// @returns `greater`, `equal` or `smaller`, never `concurrent`
+  vector_clock_result compare(const hybrid_logical_clock& other) const;
+
+  /// Merges `other` into `this`, i.e., keeps the greater timestamp. Advances
+  /// the local time of this process past `other`.
+  /// @param other `hybrid_logical_clock` to merge into `this`
+  /// @returns `other` if it is greater than `this`, an empty clock otherwise
+  hybrid_logical_clock merge(const hybrid_logical_clock& other);
+
+  /// @returns the packed timestamp
+  inline uint64_t time() const { return time_; }
+
+  /// @returns the hash of the issuing node
+  inline uint64_t node() const { return node_; }
+
+  /// @returns `true` if this clock has not been advanced yet
+  inline bool empty() const { return time_ == 0; }
+
+  /// @private
+  template <class Processor>
+  friend void serialize(Processor& proc, hybrid_logical_clock& x) {
+    proc & x.time_;
+    proc & x.node_;
+  }
+
+  /// @private
+  friend bool operator<(const hybrid_logical_clock& lhs,
+                        const hybrid_logical_clock& rhs) {
+    return lhs.compare(rhs) == smaller;
+  }
+
+private:
+  uint64_t time_ = 0; /// Physical time and logical counter
+  uint64_t node_ = 0; /// Hash of the issuing node
+};
+
+} // namespace crdt
+} // namespace caf
+
+#endif // CAF_CRDT_HYBRID_LOGICAL_CLOCK_HPP
@@ -0,0 +1,72 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+
+#ifndef CAF_CRDT_NOTIFY_METRICS_HPP
+#define CAF_CRDT_NOTIFY_METRICS_HPP
+
+#include "caf/crdt/uri.hpp"
+
+#include <mutex>
+#include <cstddef>
+#include <unordered_map>
+
+namespace caf {
+namespace crdt {
+
+/// Notify intervals chosen by the replicas of this node. Replicas only
+/// report an interval if it has changed, i.e., if adaptive intervals are
+/// enabled.
+class notify_metrics {
+public:
+  /// Records the interval of the replica of `id` in milliseconds
+  inline void record(const uri& id, size_t interval_ms) {
+    std::unique_lock<std::mutex> guard{mtx_};
+    intervals_[id] = interval_ms;
+  }
+
+  /// Forgets the replica of `id`
+  inline void erase(const uri& id) {
+    std::unique_lock<std::mutex> guard{mtx_};
+    intervals_.erase(id);
+  }
+
+  /// @returns the interval of the replica of `id` in milliseconds or `0`
+  ///          if it has not reported one
+  inline size_t interval(const uri& id) const {
+    std::unique_lock<std::mutex> guard{mtx_};
+    auto iter = intervals_.find(id);
+    return iter != intervals_.end() ? iter->second : 0;
+  }
+
+  /// @returns the intervals of all reporting replicas
+  inline std::unordered_map<uri, size_t> intervals() const {
+    std::unique_lock<std::mutex> guard{mtx_};
+    return intervals_;
+  }
+
+private:
+  mutable std::mutex mtx_;                    /// Guards `intervals_`
+  std::unordered_map<uri, size_t> intervals_; /// Interval per replica
+};
+
+} // namespace crdt
+} // namespace caf
+
+#endif // CAF_CRDT_NOTIFY_METRICS_HPP
@@ -25,6 +25,8 @@
 
 #include "caf/crdt/uri.hpp"
 #include "caf/crdt/notifiable.hpp"
+#include "caf/crdt/flush_metrics.hpp"
+#include "caf/crdt/notify_metrics.hpp"
 #include "caf/crdt/replicator_actor.hpp"
 
 #include "caf/crdt/detail/replica.hpp"
@@ -52,6 +54,17 @@ public:
 
   replicator_actor actor_handle();
 
+  /// @returns the flushes of the replicator per trigger
+  inline const flush_metrics& metrics() const { return *metrics_; }
+
+  /// @returns the notify intervals chosen by the replicas of this node
+  inline const notify_metrics& notify_intervals() const {
+    return notify_intervals_;
+  }
+
+  /// @private
+  inline notify_metrics& notify_intervals() { return notify_intervals_; }
+
   inline actor_system& system() const { return system_; }
 
 protected:
@@ -61,6 +74,9 @@ protected:
 private:
   actor_system& system_;
   replicator_actor manager_;
+  actor wheel_;
+  std::shared_ptr<flush_metrics> metrics_;
+  notify_metrics notify_intervals_;
 };
 
 } // namespace crdt
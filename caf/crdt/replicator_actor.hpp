@@ -21,41 +21,106 @@
 #define CAF_CRDT_REPLICATOR_ACTOR_HPP
 
 #include "caf/fwd.hpp"
+#include "caf/message.hpp"
 #include "caf/node_id.hpp"
 
 #include "caf/typed_actor.hpp"
 
 #include "caf/crdt/uri.hpp"
 #include "caf/crdt/atom_types.hpp"
+#include "caf/crdt/flush_metrics.hpp"
 
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <unordered_map>
 #include <unordered_set>
 
 namespace caf {
 namespace crdt {
 
+/// Buffered deltas of all uris changed since the last flush, a replicator
+/// ships one batch per intrested node and flush
+using delta_batch = std::unordered_map<uri, std::vector<message>>;
+
+/// Deltas of many uris on the wire, keyed by the id the sender has interned
+/// the uri to
+using wire_batch = std::vector<std::pair<uint32_t, std::vector<message>>>;
+
+/// Uris of ids which the receiver of a batch may not know yet
+using uri_dictionary = std::vector<std::pair<uint32_t, uri>>;
+
 /// Interface of replicator
 using replicator_actor =
   typed_actor<
     /// Replic-ID, message pair, where the message contains updates for a id
     reacts_to<uri, message>,
+    /// Write of a node which does not own the Replic-ID, its owner applies
+    /// the message as a local write
+    reacts_to<publish_atom, uri, message>,
+    /// Request of a node which does not own the Replic-ID, its owner
+    /// delegates the message to its replica
+    reacts_to<forward_atom, uri, message>,
+    /// Full state of a Replic-ID the receiver owns now, merged into its
+    /// replica without publishing it again and acknowledged to the sender
+    reacts_to<handoff_atom, uri, message>,
+    /// Acknowledges a handed off Replic-ID to the previous owner
+    reacts_to<handoff_ack_atom, uri>,
     /// Replic-ID, vector<message> pair
     reacts_to<uri, std::vector<message>>,
-    /// Internal tick message to send complete state, this messages starts the
-    /// local collection process of all states.
+    /// Deltas or states of many Replic-IDs, sent once per flush and node and
+    /// numbered by the sender, the receiver acknowledges the number
+    reacts_to<batch_atom, uint64_t, uri_dictionary, wire_batch>,
+    /// Rumor of the gossip mode: origin, sequence number at the origin,
+    /// remaining hops and deltas of many Replic-IDs, keyed by the ids of
+    /// the sending hop, which announces all of them in the dictionary
+    reacts_to<gossip_atom, node_id, uint64_t, uint32_t, uri_dictionary,
+              wire_batch>,
+    /// Zone of the sending node, announced once per connection
+    reacts_to<zone_atom, std::string>,
+    /// Acknowledges all batches up to the number to their sender
+    reacts_to<delta_ack_atom, uint64_t>,
+    /// The receiver dropped a batch of the sender with an id it does not
+    /// know, the sender announces all ids to it again
+    reacts_to<unknown_id_atom>,
+    /// Confirms `unknown_id_atom`, the sender announces all ids and resends
+    /// all unacknowledged batches after this message
+    reacts_to<reannounce_atom>,
+    /// Internal tick message to start a reconciliation round, all replicas
+    /// send the root of their digest to the replicas of intrested nodes
     reacts_to<tick_state_atom>,
+    /// Root of the digest of a remote replica, delegated to the local replica
+    /// if any, digests never spawn a replica
+    reacts_to<digest_atom, uri, uint64_t>,
     /// Response to `copy_atom`, the message contains the full state of the replic
     reacts_to<copy_ack_atom, uri, message>,
-    /// Internal tick message to flush ids
+    /// Internal tick message to push changed ids
     reacts_to<tick_ids_atom>,
-    /// Internal tick message to flush buffer
+    /// Flushes the buffer immediately
     reacts_to<tick_buffer_atom>,
+    /// Internal timer of the adaptive buffer flush
+    reacts_to<flush_timer_atom>,
     /// A new connection to a CAF node (node_id) is established
     reacts_to<new_connection_atom, node_id>,
     /// A connection to a CAF node (node_id) is lost
     reacts_to<connection_lost_atom, node_id>,
+    /// The sender has lost the node and the receiver has acknowledged the
+    /// full states of all replicas of the sender since
+    reacts_to<covered_atom, node_id>,
+    /// Internal message of a shard, which has shipped its full states to the
+    /// second node since the first node was lost
+    reacts_to<covered_atom, node_id, node_id>,
+    /// Internal message of a shard, which has spawned a replica for the uri
+    reacts_to<add_id_atom, uri>,
     /// Return a unordered set of uris to sender
     reacts_to<get_ids_atom, size_t>,
     reacts_to<size_t, std::unordered_set<uri>>,
+    /// Changes of the uris of a node since a version: base version, new
+    /// version, added and removed uris
+    reacts_to<ids_delta_atom, size_t, size_t, std::unordered_set<uri>,
+              std::unordered_set<uri>>,
     /// Subscribes a actor to a replica id
     reacts_to<subscribe_atom, uri>,
     /// Unsubscribes a actor from a replica id
@@ -81,7 +146,9 @@ using replicator_actor =
   >;
 
 ///@relates replicator_actor
-replicator_actor make_replicator_actor(actor_system& sys);
+/// @param metrics receives the flushes of the replicator per trigger
+replicator_actor make_replicator_actor(actor_system& sys,
+                                       std::shared_ptr<flush_metrics> metrics);
 
 } // namespace crdt
 } // namespace caf
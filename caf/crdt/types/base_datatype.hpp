@@ -26,6 +26,7 @@
 
 #include "caf/crdt/atom_types.hpp"
 
+#include <memory>
 #include <string>
 
 namespace caf {
@@ -58,6 +59,31 @@ namespace types {
 /// Base class for CRDTs
 class base_datatype {
 public:
+  /// Joins all deltas a state publishes while the scope is alive and
+  /// publishes them as a single delta once the outermost scope closes.
+  /// A scope must not outlive its state.
+  class batch_scope {
+  public:
+    explicit batch_scope(base_datatype& state) : state_(&state) {
+      ++state_->batch_depth_;
+    }
+
+    batch_scope(batch_scope&& other) : state_(other.state_) {
+      other.state_ = nullptr;
+    }
+
+    batch_scope(const batch_scope&) = delete;
+    batch_scope& operator=(const batch_scope&) = delete;
+
+    ~batch_scope() {
+      if (state_ && --state_->batch_depth_ == 0)
+        state_->flush();
+    }
+
+  private:
+    base_datatype* state_; /// Batching state
+  };
+
   /// @private
   base_datatype() = default;
 
@@ -72,7 +98,21 @@ public:
     }
   }
 
+  /// Copies owner and id, pending deltas stay with `other`
+  base_datatype(const base_datatype& other)
+    : owner_(other.owner_), id_(other.id_) {
+    // nop
+  }
+
+  /// Copies owner and id, pending deltas stay with `other`
+  base_datatype& operator=(const base_datatype& other) {
+    owner_ = other.owner_;
+    id_ = other.id_;
+    return *this;
+  }
+
   virtual ~base_datatype() {
+    flush();
     if (id_.valid() && owner_) {
       auto hdl = owner_.home_system().replicator().actor_handle();
       send_as(owner_, hdl, unsubscribe_atom::value, uri{id_});
@@ -85,20 +125,75 @@ public:
   /// @returns the owner of this state
   inline const actor& owner() const { return owner_; }
 
+  /// Opens a batching scope for this state
+  inline batch_scope batch() { return batch_scope{*this}; }
+
+  /// Publishes the joined delta of the current batch immediately
+  void flush() {
+    send_pending();
+  }
+
 protected:
-  /// Publishes a delta crdt state to the replicator
+  /// @returns the node of the owner, clocks use it to scope their slots
+  inline node_id owner_node() const {
+    return owner_ ? owner_.node() : node_id{};
+  }
+
+  /// Publishes a delta crdt state to the replicator. Inside a batching
+  /// scope, the delta is joined into the pending delta instead.
   /// @param data the delta to be pushed to replicator
   template <class Data>
   void publish(const Data& data) const {
     if (!id_.valid())
       return;
+    if (batch_depth_ > 0) {
+      if (pending_)
+        static_cast<pending_delta<Data>&>(*pending_).delta.merge(data);
+      else
+        pending_.reset(new pending_delta<Data>(data));
+      return;
+    }
     auto hdl = owner_.home_system().replicator().actor_handle();
     send_as(owner_, hdl, id_, make_message(data));
   }
 
 private:
+  /// Sends the pending delta to the replicator
+  void send_pending() const {
+    if (!pending_)
+      return;
+    auto hdl = owner_.home_system().replicator().actor_handle();
+    send_as(owner_, hdl, id_, pending_->make());
+    pending_.reset();
+  }
+
+  /// @private
+  struct pending_base {
+    virtual ~pending_base() {
+      // nop
+    }
+
+    virtual message make() = 0;
+  };
+
+  /// @private
+  template <class Data>
+  struct pending_delta : pending_base {
+    pending_delta(const Data& x) : delta(x) {
+      // nop
+    }
+
+    message make() override {
+      return make_message(std::move(delta));
+    }
+
+    Data delta;
+  };
+
   actor owner_; /// Owner of this state
   uri id_;      /// Replic-ID
+  mutable std::unique_ptr<pending_base> pending_; /// Joined deltas of a batch
+  size_t batch_depth_ = 0;                        /// Open batching scopes
 };
 
 } // namespace types
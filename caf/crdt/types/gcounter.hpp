@@ -20,80 +20,369 @@
 #ifndef CAF_CRDT_TYPES_GCOUNTER_HPP
 #define CAF_CRDT_TYPES_GCOUNTER_HPP
 
-#include <tuple>
 #include <vector>
+#include <algorithm>
+#include <type_traits>
 #include <unordered_map>
 
-#include "caf/crdt/types/base_datatype.hpp"
+#include "caf/node_id.hpp"
 
-// TODO: Add unit test for this type!
+#include "caf/crdt/types/base_datatype.hpp"
+#include "caf/crdt/detail/digest.hpp"
+#include "caf/crdt/detail/slot_registry.hpp"
 
 namespace caf {
 namespace crdt {
 namespace types {
 
-/// Implementation of a grow-only counter (GCounter)
-template <class T>
+/// Slot policy of `gcounter`: every incrementing actor owns a slot
+struct actor_slots {};
+
+/// Slot policy of `gcounter`: all actors on a node share the slot of their
+/// node. Increments of named counters aggregate into a running sum per node
+/// and replica, which bounds the state by the size of the cluster. Unnamed
+/// counters have no replica and fall back to `actor_slots`.
+struct node_slots {};
+
+/// Implementation of a grow-only counter (GCounter). Slots are interned and
+/// stored as a flat array sorted by id, the count is maintained as running
+/// total. Entries of retired nodes are folded into one base value per node.
+/// `Slots` selects whether slots belong to actors or to nodes, all instances
+/// of a replica must use the same policy.
+template <class T, class Slots = actor_slots>
 class gcounter : public base_datatype {
+  static_assert(std::is_same<Slots, actor_slots>::value
+                || std::is_same<Slots, node_slots>::value,
+                "Slots must be either actor_slots or node_slots");
+
+  static_assert(!std::is_same<Slots, node_slots>::value
+                || std::is_integral<T>::value,
+                "node_slots requires an integral value type");
+
+  /// Interned id of a slot
+  using slot_id = detail::slot_registry::slot_id;
+
   /// @private
-  gcounter(std::unordered_map<actor, T> map)
-    : base_datatype(), map_(std::move(map)) {
-    // nop
+  using registry = detail::slot_registry;
+
+  /// @private
+  gcounter(std::vector<slot_id> slots, std::vector<T> values,
+           std::unordered_map<node_id, T> base = {})
+    : base_datatype(), slots_(std::move(slots)), values_(std::move(values)),
+      base_(std::move(base)) {
+    recount();
   }
 
 public:
+  /// Serialized representation of a single slot, interned ids are only valid
+  /// inside a process and are never shipped.
+  struct slot_entry {
+    node_id node;
+    actor_id aid;
+    T value;
+
+    /// @private
+    template <class Processor>
+    friend void serialize(Processor& proc, slot_entry& x) {
+      proc & x.node;
+      proc & x.aid;
+      proc & x.value;
+    }
+  };
+
   DECL_CRDT_CTORS(gcounter)
 
   /// Increment the counter by value
   /// @param value to increment
   void increment_by(T value) {
-    auto key = this->owner();
-    value = map_[key] += value;
-    std::unordered_map<actor, T> tmp;
-    tmp.emplace(key, value);
-    publish(gcounter{std::move(tmp)});
+    auto& reg = registry::instance();
+    auto& hdl = owner();
+    auto aggregate = std::is_same<Slots, node_slots>::value && !id().empty();
+    auto slot = aggregate ? reg.intern(owner_node())
+                          : reg.intern({owner_node(),
+                                        hdl ? hdl.id() : actor_id{0}});
+    auto pos = lower_bound(slot);
+    if (pos == slots_.size() || slots_[pos] != slot) {
+      slots_.insert(slots_.begin() + pos, slot);
+      values_.insert(values_.begin() + pos, T{0});
+    }
+    if (aggregate) {
+      // The node sum includes all local increments so far, it is at least
+      // the value any local instance of this replica has seen for the slot.
+      auto sum = static_cast<T>(
+        reg.add_counter(slot, id(), static_cast<uint64_t>(value)));
+      if (values_[pos] < sum) {
+        account(slot, sum - values_[pos]);
+        values_[pos] = sum;
+      }
+    } else {
+      values_[pos] += value;
+      account(slot, value);
+    }
+    publish(gcounter{{slot}, {values_[pos]}});
   }
 
   /// Increment the counter by one
   void increment() { increment_by(1); }
 
-  /// Get the count of the counter
+  /// Get the count of the counter in constant time
   /// @return the count
   inline T count() const {
-    auto binary_op = [](T value, const std::pair<actor, T>& p) {
-      return value + p.second;
-    };
-    return std::accumulate(map_.begin(), map_.end(), 0, binary_op);
+    return total_;
   }
 
   /// Merges two CRDT instances
   /// @param other delta-CRDT to merge into this
-  /// @returns a delta gcounter<T>
-  gcounter<T> merge(const gcounter<T>& other) {
-    std::unordered_map<actor, T> delta;
-    for (auto& elem : other.map_) {
-      auto& key = elem.first;
-      auto& value = map_[key];
-      if (value < elem.second) {
-        value = elem.second;
-        delta.emplace(key, elem.second);
+  /// @returns a delta gcounter
+  gcounter merge(const gcounter& other) {
+    auto& reg = registry::instance();
+    if (generation_ != reg.generation())
+      compact();
+    gcounter delta;
+    // Merge base values first, slots of newly based nodes move from the
+    // running total into `unfolded_`, which requires a recount.
+    bool new_base = false;
+    for (auto& elem : other.base_) {
+      auto i = base_.find(elem.first);
+      if (i == base_.end()) {
+        base_.emplace(elem);
+        new_base = true;
+      } else if (i->second < elem.second) {
+        auto u = unfolded_[elem.first];
+        total_ += std::max(elem.second, u) - std::max(i->second, u);
+        i->second = elem.second;
+      } else {
+        continue;
       }
+      delta.base_.emplace(elem);
     }
-    return {std::move(delta)};
+    std::shared_ptr<const std::vector<slot_id>> retired;
+    if (generation_ != 0)
+      retired = reg.retired_slots();
+    auto is_retired = [&](slot_id x) {
+      return retired
+             && std::binary_search(retired->begin(), retired->end(), x);
+    };
+    // Raise existing slots and count missing slots in one pass
+    size_t missing = 0;
+    auto n = slots_.size();
+    size_t i = 0;
+    for (size_t j = 0; j < other.slots_.size(); ++j) {
+      auto id = other.slots_[j];
+      auto x = other.values_[j];
+      while (i < n && slots_[i] < id)
+        ++i;
+      if (i < n && slots_[i] == id) {
+        if (values_[i] < x) {
+          account(id, x - values_[i]);
+          values_[i] = x;
+          delta.slots_.push_back(id);
+          delta.values_.push_back(x);
+        }
+      } else if (!is_retired(id)) {
+        ++missing;
+        account(id, x);
+        delta.slots_.push_back(id);
+        delta.values_.push_back(x);
+      }
+    }
+    if (missing > 0)
+      insert_missing(delta, missing);
+    if (new_base)
+      recount();
+    delta.recount();
+    return delta;
+  }
+
+  /// Folds the entries of retired nodes into their base value. Called lazily
+  /// by `merge` whenever a node has been retired since the last compaction.
+  /// @returns `true` if entries have been folded
+  bool compact() {
+    auto& reg = registry::instance();
+    generation_ = reg.generation();
+    auto retired = reg.retired_slots();
+    if (!retired || slots_.empty())
+      return false;
+    std::vector<slot_id> folded_slots;
+    std::vector<T> folded_values;
+    size_t k = 0;
+    for (size_t i = 0; i < slots_.size(); ++i) {
+      if (std::binary_search(retired->begin(), retired->end(), slots_[i])) {
+        folded_slots.push_back(slots_[i]);
+        folded_values.push_back(values_[i]);
+        continue;
+      }
+      slots_[k] = slots_[i];
+      values_[k] = values_[i];
+      ++k;
+    }
+    if (folded_slots.empty())
+      return false;
+    slots_.resize(k);
+    values_.resize(k);
+    std::vector<registry::key_type> keys;
+    reg.keys(folded_slots.data(), folded_slots.size(), keys);
+    std::unordered_map<node_id, T> sums;
+    for (size_t i = 0; i < keys.size(); ++i)
+      sums[keys[i].first] += folded_values[i];
+    for (auto& x : sums) {
+      auto& value = base_[x.first];
+      value = std::max(value, x.second);
+    }
+    recount();
+    return true;
   }
 
   /// @returns `true` if the state is empty
   ///          `false` otherwise
-  inline bool empty() const { return map_.empty(); }
+  inline bool empty() const { return slots_.empty() && base_.empty(); }
+
+  /// @returns a fingerprint which does not depend on the interned ids or the
+  ///          order of base values, all entries are summed up
+  uint64_t fingerprint() const {
+    std::vector<registry::key_type> keys;
+    registry::instance().keys(slots_.data(), slots_.size(), keys);
+    uint64_t result = 0;
+    for (size_t i = 0; i < keys.size(); ++i)
+      detail::fingerprint_add(result, detail::fingerprint(
+        slot_entry{std::move(keys[i].first), keys[i].second, values_[i]}));
+    for (auto& x : base_)
+      detail::fingerprint_add(result, detail::fingerprint_combine(
+        detail::fingerprint(x.first), detail::fingerprint(x.second)));
+    return result;
+  }
 
   /// @private
   template <class Processor>
-  friend void serialize(Processor& proc, gcounter<T>& x) {
-    proc & x.map_;
+  friend void serialize(Processor& proc, gcounter& x) {
+    x.serialize_impl(proc, typename Processor::is_saving{});
   }
 
 private:
-  std::unordered_map<actor, T> map_; /// Map nodes to values
+  /// @private
+  template <class Processor>
+  void serialize_impl(Processor& proc, std::true_type) {
+    std::vector<registry::key_type> keys;
+    registry::instance().keys(slots_.data(), slots_.size(), keys);
+    std::vector<slot_entry> xs;
+    xs.reserve(keys.size());
+    for (size_t i = 0; i < keys.size(); ++i)
+      xs.push_back(slot_entry{std::move(keys[i].first), keys[i].second,
+                              values_[i]});
+    proc & xs;
+    proc & base_;
+  }
+
+  /// @private
+  template <class Processor>
+  void serialize_impl(Processor& proc, std::false_type) {
+    std::vector<slot_entry> xs;
+    proc & xs;
+    proc & base_;
+    std::vector<registry::key_type> keys;
+    keys.reserve(xs.size());
+    for (auto& x : xs)
+      keys.emplace_back(x.node, x.aid);
+    std::vector<slot_id> ids;
+    registry::instance().intern(keys.data(), keys.size(), ids);
+    std::vector<size_t> order(xs.size());
+    for (size_t i = 0; i < order.size(); ++i)
+      order[i] = i;
+    std::sort(order.begin(), order.end(),
+              [&](size_t lhs, size_t rhs) { return ids[lhs] < ids[rhs]; });
+    slots_.clear();
+    values_.clear();
+    for (auto idx : order) {
+      if (!slots_.empty() && slots_.back() == ids[idx]) {
+        values_.back() = std::max(values_.back(), xs[idx].value);
+        continue;
+      }
+      slots_.push_back(ids[idx]);
+      values_.push_back(xs[idx].value);
+    }
+    recount();
+  }
+
+  /// @returns the index of `slot` or the position it would be inserted at
+  size_t lower_bound(slot_id slot) const {
+    auto iter = std::lower_bound(slots_.begin(), slots_.end(), slot);
+    return static_cast<size_t>(std::distance(slots_.begin(), iter));
+  }
+
+  /// Inserts the `missing` slots of `delta` which are not in `this` yet.
+  /// Both arrays are sorted, merging back to front grows `this` in place.
+  void insert_missing(const gcounter& delta, size_t missing) {
+    auto n = slots_.size();
+    slots_.resize(n + missing);
+    values_.resize(n + missing);
+    auto i = n;
+    auto j = delta.slots_.size();
+    auto k = n + missing;
+    while (k > i) {
+      if (i > 0 && slots_[i - 1] >= delta.slots_[j - 1]) {
+        if (slots_[i - 1] == delta.slots_[j - 1])
+          --j; // Raised slot, already up to date in `this`
+        --i;
+        --k;
+        slots_[k] = slots_[i];
+        values_[k] = values_[i];
+      } else {
+        --j;
+        --k;
+        slots_[k] = delta.slots_[j];
+        values_[k] = delta.values_[j];
+      }
+    }
+  }
+
+  /// Adds `diff` of `slot` to the running total
+  void account(slot_id slot, T diff) {
+    if (!base_.empty()) {
+      auto node = registry::instance().key(slot).first;
+      auto i = base_.find(node);
+      if (i != base_.end()) {
+        // Entries and base of a node are sums over the same increments,
+        // the greater one is the contribution of this node.
+        auto& u = unfolded_[node];
+        auto before = std::max(i->second, u);
+        u += diff;
+        total_ += std::max(i->second, u) - before;
+        return;
+      }
+    }
+    total_ += diff;
+  }
+
+  /// Recomputes the running total
+  void recount() {
+    total_ = T{0};
+    unfolded_.clear();
+    if (base_.empty()) {
+      for (auto& x : values_)
+        total_ += x;
+      return;
+    }
+    std::vector<registry::key_type> keys;
+    registry::instance().keys(slots_.data(), slots_.size(), keys);
+    for (size_t i = 0; i < keys.size(); ++i) {
+      if (base_.count(keys[i].first) > 0)
+        unfolded_[keys[i].first] += values_[i];
+      else
+        total_ += values_[i];
+    }
+    for (auto& x : base_) {
+      auto iter = unfolded_.find(x.first);
+      total_ += iter == unfolded_.end() ? x.second
+                                        : std::max(x.second, iter->second);
+    }
+  }
+
+  std::vector<slot_id> slots_;              /// Sorted ids of all slots
+  std::vector<T> values_;                   /// Values, parallel to `slots_`
+  std::unordered_map<node_id, T> base_;     /// Folded values of retired nodes
+  std::unordered_map<node_id, T> unfolded_; /// Slot sums of based nodes
+  T total_ = 0;                             /// Running total of all slots
+  uint64_t generation_ = 0;                 /// Registry generation of last fold
 };
 
 } // namespace types
@@ -20,9 +20,14 @@
 #ifndef CAF_CRDT_TYPES_GMAP_HPP
 #define CAF_CRDT_TYPES_GMAP_HPP
 
+#include "caf/crdt/detail/digest.hpp"
+#include "caf/crdt/detail/merge_join.hpp"
+
 #include "caf/crdt/types/base_datatype.hpp"
 
 #include <map>
+#include <vector>
+#include <cstdint>
 
 namespace caf {
 namespace crdt {
@@ -55,14 +60,28 @@ public:
   /// @returns a gmap representing the delta
   gmap merge(const gmap& other) {
     Container delta;
+    // Both maps are sorted, walk them in one pass for large states and
+    // insert with a hint. Small deltas look up each key instead.
+    auto cmp = map_.key_comp();
+    auto linear = detail::prefer_linear_merge(map_.size(), other.map_.size());
+    auto i = map_.begin();
     for (auto& entry : other.map_) {
       auto& key = entry.first;
-      auto& value = map_[key];
+      if (linear) {
+        while (i != map_.end() && cmp(i->first, key))
+          ++i;
+      } else {
+        i = map_.lower_bound(key);
+      }
+      if (i == map_.end() || cmp(key, i->first))
+        i = map_.emplace_hint(i, key, Value{});
+      auto& value = i->second;
       if (value < entry.second) {
         value = entry.second;
-        delta.emplace(key, entry.second);
+        delta.emplace_hint(delta.end(), key, entry.second);
       } else if (value > entry.second)
-        delta.emplace(key, value);
+        delta.emplace_hint(delta.end(), key, value);
+      ++i;
     }
     return {std::move(delta)};
   }
@@ -100,6 +119,26 @@ public:
   /// @returns the size of the map
   inline size_t size() const { return map_.size(); }
 
+  /// Calls `f` with the key and entry fingerprint of each entry, keys select
+  /// the range of an entry
+  template <class F>
+  void digest(F f) const {
+    for (auto& entry : map_) {
+      auto key = detail::fingerprint(entry.first);
+      f(key, key ^ detail::digest_mix(detail::fingerprint(entry.second)));
+    }
+  }
+
+  /// @returns the entries whose key fingerprint satisfies `pred`
+  template <class Predicate>
+  gmap slice(Predicate pred) const {
+    Container result;
+    for (auto& entry : map_)
+      if (pred(detail::fingerprint(entry.first)))
+        result.emplace_hint(result.end(), entry);
+    return {std::move(result)};
+  }
+
   /// @private
   template <class Processor>
   friend void serialize(Processor& proc, gmap& x) {
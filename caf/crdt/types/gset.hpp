@@ -21,42 +21,89 @@
 #define CAF_CRDT_TYPES_GSET_HPP
 
 #include <set>
+#include <vector>
 #include <algorithm>
+#include <type_traits>
 
 #include "caf/detail/comparable.hpp"
 
+#include "caf/crdt/detail/digest.hpp"
+#include "caf/crdt/detail/flat_set.hpp"
+#include "caf/crdt/detail/hash_set.hpp"
+#include "caf/crdt/detail/merge_join.hpp"
+#include "caf/crdt/detail/roaring_bitmap.hpp"
+
 #include "caf/crdt/types/base_datatype.hpp"
 
 namespace caf {
 namespace crdt {
 namespace types {
 
-/// GSet implementation as delta-CRDT
+/// Evaluates to `true` if `Container` iterates its elements in order
+/// @relates gset
+template <class Container>
+struct is_ordered_set : std::true_type {};
+
+/// @relates gset
+template <class T, class Hash, class Equal>
+struct is_ordered_set<detail::hash_set<T, Hash, Equal>> : std::false_type {};
+
+/// Selects the default container of `gset<T>`
+/// @relates gset
+template <class T, class = void>
+struct default_set_container {
+  using type = std::set<T>;
+};
+
+/// Integers are stored in a compressed bitmap
+/// @relates gset
 template <class T>
-class gset : public base_datatype, caf::detail::comparable<gset<T>> {
+struct default_set_container<
+  T, typename std::enable_if<std::is_integral<T>::value
+                             && !std::is_same<T, bool>::value>::type> {
+  using type = detail::roaring_set<T>;
+};
+
+/// GSet implementation as delta-CRDT. The elements are stored in `Container`:
+///  - `detail::roaring_set<T>` is the default for integers, a compressed
+///    bitmap which merges dense sets word-wise
+///  - `std::set<T>` is the default for all other types
+///  - `detail::flat_set<T>` stores a sorted vector, suited for read-heavy sets
+///  - `detail::hash_set<T>` is an open addressing hash set, suited for large
+///    sets with frequent membership tests. Iteration is unordered.
+template <class T,
+          class Container = typename default_set_container<T>::type>
+class gset : public base_datatype,
+             caf::detail::comparable<gset<T, Container>> {
+  /// @private
+  using ordered = std::integral_constant<bool,
+                                         is_ordered_set<Container>::value>;
+
   /// @private
   gset(const T& elem) : set_{elem} {
     // nop
   }
 
   /// @private
-  gset(std::set<T> set) : set_{std::move(set)} {
+  gset(Container set) : set_{std::move(set)} {
     // nop
   }
 
 public:
   using value_type = T;
 
+  using container_type = Container;
+
+  using const_iterator = typename Container::const_iterator;
+
   DECL_CRDT_CTORS(gset)
 
   /// Merge another gset state into this
   /// @param other delta-CRDT to merge into this
   /// @returns a delta gset<T>
-  gset<T> merge(const gset<T>& other) {
-    std::set<T> delta;
-    for (auto& elem : other.set_)
-      if (internal_emplace(elem))
-        delta.emplace(elem);
+  gset merge(const gset& other) {
+    Container delta;
+    detail::merge_into(set_, other.set_, delta);
     return {std::move(delta)};
   }
 
@@ -75,11 +122,11 @@ public:
   /// @param elems to insert
   /// @returns a set of operations done to the gset
   void subset_insert(const std::set<T>& elems) {
-    std::set<T> insertions;
+    Container insertions;
     for (auto& elem : elems)
       if (internal_emplace(elem))
-        insertions.emplace(elem);
-    this->publish(gset{std::set<T>{std::move(insertions)}});
+        insertions.insert(insertions.end(), elem);
+    this->publish(gset{std::move(insertions)});
   }
 
   /// Checks if `elem` is in the set
@@ -88,49 +135,67 @@ public:
     return set_.find(elem) != set_.end();
   }
 
-  /// Checks if `other` includes `other`.
+  /// Checks if `other` includes `this`.
   /// @param other set of elements
   bool is_subset_of(const std::set<T>& other) const {
-    return std::includes(other.begin(), other.end(), set_.begin(), other.end());
+    return includes(other, set_, ordered{});
   }
 
-  /// Checks if `other` includes `other`.
+  /// Checks if `other` includes `this`.
   /// @param other set of elements
   bool is_subset_of(const gset& other) const {
-    return is_subset_of(other.set_);
+    return includes(other.set_, set_, ordered{});
   }
 
   /// Checks if `this` includes `other`.
   /// @param other set of elements
   bool is_superset_of(const std::set<T>& other) const {
-    return std::includes(set_.begin(), set_.end(), other.begin(), other.end());
+    return includes(set_, other, ordered{});
   }
 
   /// Checks if `this` includes `other`.
   /// @param other set of elements
   bool is_superset_of(const gset& other) const {
-    return is_superset_of(other.set_);
+    return includes(set_, other.set_, ordered{});
   }
 
   /// Checks if `other` and `this` are equal.
   bool equal(const std::set<T>& other) const {
-    return set_ == other;
+    return set_.size() == other.size() && includes(other, set_, ordered{});
   }
 
   /// @returns the number of elements in the set
   size_t size() const { return set_.size(); }
 
+  /// Calls `f` with the key and entry fingerprint of each element, replicas
+  /// exchange only the elements of differing key ranges
+  template <class F>
+  void digest(F f) const {
+    for (const T& x : set_) {
+      auto fp = detail::fingerprint(x);
+      f(fp, fp);
+    }
+  }
+
+  /// @returns the elements whose fingerprint satisfies `pred`
+  template <class Predicate>
+  gset slice(Predicate pred) const {
+    Container result;
+    for (const T& x : set_)
+      if (pred(detail::fingerprint(x)))
+        result.insert(result.end(), x);
+    return {std::move(result)};
+  }
+
   /// @private
   template <class Processor>
-  friend void serialize(Processor& proc, gset<T>& x) {
+  friend void serialize(Processor& proc, gset& x) {
     proc & x.set_;
   }
 
   /// @private
-  intptr_t compare(const gset<T>& other) const noexcept {
-    if (set_ == other.set_)     return 0;
-    else if (set_ < other.set_) return -1;
-    else                        return 1;
+  intptr_t compare(const gset& other) const noexcept {
+    return compare_impl(other, ordered{});
   }
 
   /// Check if the set is empty
@@ -139,22 +204,22 @@ public:
   inline size_t empty() const { return set_.empty(); }
 
   /// @returns a iterator pointing to the beginning of the set
-  inline typename std::set<T>::const_iterator cbegin() const {
+  inline const_iterator cbegin() const {
     return set_.cbegin();
   }
 
   /// @returns a iterator pointing to the ending of the set
-  inline typename std::set<T>::const_iterator cend() const {
+  inline const_iterator cend() const {
     return set_.cend();
   }
 
   /// @returns a iterator pointing to the beginning of the set
-  inline typename std::set<T>::iterator begin() const {
+  inline const_iterator begin() const {
     return set_.begin();
   }
 
   /// @returns a iterator pointing to the ending of the set
-  inline typename std::set<T>::iterator end() const {
+  inline const_iterator end() const {
     return set_.end();
   }
 
@@ -164,7 +229,40 @@ private:
     return std::get<1>(set_.emplace(elem));
   }
 
-  std::set<T> set_; /// Set of elements
+  /// @returns `true` if every element of `xs` is in `ys`
+  template <class Ys, class Xs>
+  static bool includes(const Ys& ys, const Xs& xs, std::true_type) {
+    return std::includes(ys.begin(), ys.end(), xs.begin(), xs.end());
+  }
+
+  /// @private
+  template <class Ys, class Xs>
+  static bool includes(const Ys& ys, const Xs& xs, std::false_type) {
+    return xs.size() <= ys.size()
+           && std::all_of(xs.begin(), xs.end(),
+                          [&](const T& x) { return ys.find(x) != ys.end(); });
+  }
+
+  /// @private
+  intptr_t compare_impl(const gset& other, std::true_type) const {
+    if (set_ == other.set_)     return 0;
+    else if (set_ < other.set_) return -1;
+    else                        return 1;
+  }
+
+  /// @private
+  intptr_t compare_impl(const gset& other, std::false_type) const {
+    if (set_ == other.set_)
+      return 0;
+    // Unordered containers only compare for equality, order sorted copies
+    std::vector<T> xs{set_.begin(), set_.end()};
+    std::vector<T> ys{other.set_.begin(), other.set_.end()};
+    std::sort(xs.begin(), xs.end());
+    std::sort(ys.begin(), ys.end());
+    return xs < ys ? -1 : 1;
+  }
+
+  Container set_; /// Set of elements
 };
 
 } // namespace types
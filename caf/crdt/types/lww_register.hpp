@@ -21,6 +21,10 @@
 #define CAF_CRDT_TYPES_LWW_REGISTER_HPP
 
 #include "caf/crdt/vector_clock.hpp"
+#include "caf/crdt/hybrid_logical_clock.hpp"
+
+#include "caf/crdt/detail/digest.hpp"
+#include "caf/crdt/detail/lww_stamp.hpp"
 
 #include "caf/crdt/types/base_datatype.hpp"
 
@@ -28,81 +32,80 @@ namespace caf {
 namespace crdt {
 namespace types {
 
-/// Last Writer Wins Register (LWW-Register) implementation as delta-CRDT
-template <class T>
+/// Last Writer Wins Register (LWW-Register) implementation as delta-CRDT.
+/// The `Clock` orders all writes:
+///  - `vector_clock` increments the clock slot of the writing node, concurrent
+///    writes on different nodes are ordered by their setter.
+///  - `hybrid_logical_clock` orders writes by physical time, which keeps
+///    timestamps at 16 bytes but lets the clock with the greater time win
+///    over causally later writes if clocks of nodes are skewed.
+template <class T, class Clock = vector_clock>
 class lww_register : public base_datatype {
   /// @private
-  lww_register(vector_clock clk, actor setter, T value)
-    : clk_{std::move(clk)}, setter_{std::move(setter)},
-      value_{std::move(value)} {
+  using stamp_type = detail::lww_stamp<Clock>;
+
+  /// @private
+  lww_register(stamp_type stamp, T value)
+    : stamp_{std::move(stamp)}, value_{std::move(value)} {
     // nop
   }
 
 public:
   using value_type = T;
 
+  using clock_type = Clock;
+
   DECL_CRDT_CTORS(lww_register)
 
   /// Merge another lww_register state into this
   /// @param other delta-CRDT to merge into this
   /// @returns a delta lww_register<T>
-  lww_register<T> merge(const lww_register<T>& other) {
-    auto transfer = [&](const lww_register<T>& value) {
-      this->clk_    = value.clk_;
-      this->setter_ = value.setter_;
-      this->value_  = value.value_;
-      return value;
-    };
-    switch(clk_.compare(other.clk_)) {
-      case greater:
-        return transfer(other);
-      case equal:
-      case smaller:
-        return {};
-      case concurrent:
-        if (setter_ == other.setter_) return {};
-        else if (setter_ > other.setter_) return {};
-        else if (setter_ < other.setter_) return transfer(other);
-    }
-    return {};
+  lww_register merge(const lww_register& other) {
+    if (stamp_.compare(other.stamp_) != smaller)
+      return {};
+    stamp_.adopt(other.stamp_);
+    value_ = other.value_;
+    return {stamp_, value_};
   }
 
   /// Set a new element to the register
   /// @param value to set
   void set(const T& value) {
-    clk_ = clk_.increment(owner());
-    setter_ = owner();
+    stamp_.stamp(owner(), owner_node(), id());
     value_ = value;
-    publish(lww_register<T>{clk_, setter_, value_});
+    publish(lww_register{stamp_, value_});
   }
 
   /// Move a new element to the register
   /// @param value to set
   void set(T&& value) {
-    clk_ = clk_.increment(owner());
-    setter_ = owner();
+    stamp_.stamp(owner(), owner_node(), id());
     value_ = std::move(value);
-    publish(lww_register<T>{clk_, setter_, value_});
+    publish(lww_register{stamp_, value_});
   }
 
   /// @returns the current element
   inline const T& get() const { return value_; }
 
+  /// @returns a fingerprint which does not depend on the interned ids
+  uint64_t fingerprint() const {
+    return detail::fingerprint_combine(detail::fingerprint(stamp_),
+                                       detail::fingerprint(value_));
+  }
+
   /// @private
   template <class Processor>
-  friend void serialize(Processor& proc, lww_register<T>& x) {
-    proc & x.clk_;
-    proc & x.setter_;
+  friend void serialize(Processor& proc, lww_register& x) {
+    proc & x.stamp_;
     proc & x.value_;
   }
 
   /// @private
-  inline size_t empty() const { return clk_.count() == 0; }
+  inline size_t empty() const { return stamp_.empty(); }
 
 private:
-  vector_clock clk_;  /// Timestamp of current element
-  actor setter_;      /// Setter of current element
-  T value_;           /// Current element
+  stamp_type stamp_; /// Timestamp of current element
+  T value_;          /// Current element
 };
 
 } // namespace types
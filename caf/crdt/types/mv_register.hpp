@@ -21,26 +21,28 @@
 #ifndef CAF_CRDT_TYPES_MV_REGISTER_HPP
 #define CAF_CRDT_TYPES_MV_REGISTER_HPP
 
-#include "caf/crdt/vector_clock.hpp"
+#include "caf/crdt/dotted_version_vector.hpp"
+
+#include "caf/crdt/detail/digest.hpp"
 
 #include "caf/crdt/types/base_datatype.hpp"
 
+#include <set>
+#include <tuple>
+
 namespace caf {
 namespace crdt {
 namespace types {
 
-/// Multi-Value-Register (MV-Register)
+/// Multi-Value-Register (MV-Register). Values are tagged with dotted version
+/// vectors, hence the causal context grows with the number of nodes instead
+/// of the number of writing actors.
 template <class T>
 class mv_register : public base_datatype {
+  using entry = std::tuple<T, dotted_version_vector>;
 
-  mv_register(std::set<std::tuple<T, vector_clock>> value,
-              vector_clock&& clk)
-    : register_{value}, clk_{std::move(clk)} {
-    // nop
-  }
-
-  mv_register(std::set<std::tuple<T, vector_clock>>&& set, vector_clock clk)
-    : register_{std::move(set)}, clk_{std::move(clk)} {
+  mv_register(std::set<entry> set, causal_context ctx)
+    : register_{std::move(set)}, ctx_{std::move(ctx)} {
     // nop
   }
 
@@ -52,13 +54,13 @@ public:
   /// Set a new element to the register
   /// @param value to set
   void set(const T& value) {
-    auto clock = clk_.increment(owner());
-    register_ = {std::make_tuple(value, clock)};
-    publish(mv_register{register_, std::move(clock)});
+    auto event = ctx_.next(owner_node(), id());
+    register_ = {std::make_tuple(value, dotted_version_vector{ctx_, event})};
+    publish(mv_register{register_, ctx_});
   }
 
   /// @returns the current set of elements
-  const std::set<std::tuple<T, vector_clock>>& get_set() const {
+  const std::set<entry>& get_set() const {
     return register_;
   }
 
@@ -71,39 +73,69 @@ public:
     return std::get<0>(*register_.begin());
   }
 
-  ///
+  /// Merges two instances of mv_register
+  /// @param other delta-CRDT to merge into this
+  /// @returns a delta mv_register<T>
   mv_register merge(const mv_register& other) {
-    std::set<std::tuple<T, vector_clock>> delta;
-    switch(other.clk_.compare(clk_)) {
-      case greater:
-        register_ = other.register_;
-        delta     = other.register_;
-        break;
-      case smaller:
-      case equal:
-        return {};
-      case concurrent:
-        register_.insert(other.register_.begin(), other.register_.end());
-        std::set_symmetric_difference(register_.begin(), register_.end(),
-                                      other.register_.begin(),
-                                      other.register_.end(),
-                                      std::inserter(delta, delta.begin()));
-        break;
+    bool changed = false;
+    // Drop own values which `other` has seen and overwritten
+    for (auto i = register_.begin(); i != register_.end();) {
+      auto& event = std::get<1>(*i).event();
+      if (other.ctx_.contains(event) && !other.contains(event)) {
+        i = register_.erase(i);
+        changed = true;
+      } else {
+        ++i;
+      }
     }
-    clk_.merge(other.clk_);
-    return {std::move(delta), clk_};
+    // Add values of `other` which `this` has not seen yet
+    for (auto& e : other.register_)
+      if (!ctx_.contains(std::get<1>(e).event()) && register_.insert(e).second)
+        changed = true;
+    changed |= ctx_.merge(other.ctx_);
+    if (!changed)
+      return {};
+    // The delta carries all values covered by the context of `other`,
+    // otherwise merging the delta would drop them.
+    std::set<entry> delta;
+    for (auto& e : register_)
+      if (other.ctx_.contains(std::get<1>(e).event()))
+        delta.insert(e);
+    return {std::move(delta), other.ctx_};
+  }
+
+  /// @returns `true` if the state is empty
+  ///          `false` otherwise
+  inline bool empty() const { return register_.empty() && ctx_.empty(); }
+
+  /// @returns a fingerprint which does not depend on the interned ids, the
+  ///          values are ordered by them and are summed up instead
+  uint64_t fingerprint() const {
+    uint64_t values = 0;
+    for (auto& e : register_)
+      detail::fingerprint_add(values, detail::fingerprint_combine(
+        detail::fingerprint(std::get<0>(e)), std::get<1>(e).fingerprint()));
+    return detail::fingerprint_combine(ctx_.fingerprint(), values);
   }
 
   /// @private
   template <class Processor>
   friend void serialize(Processor& proc, mv_register<T>& x) {
     proc & x.register_;
-    proc & x.clk_;
+    proc & x.ctx_;
   }
 
 private:
-  std::set<std::tuple<T, vector_clock>> register_;
-  vector_clock clk_;
+  /// @returns `true` if a value with `event` is in the register
+  bool contains(const dot& event) const {
+    for (auto& e : register_)
+      if (std::get<1>(e).event() == event)
+        return true;
+    return false;
+  }
+
+  std::set<entry> register_; /// Current values
+  causal_context ctx_;       /// Events seen by this register
 };
 
 } // namespace types
@@ -25,10 +25,16 @@
 
 #include "caf/detail/comparable.hpp"
 
+#include <cctype>
+#include <string>
+#include <cstring>
+#include <functional>
+
 namespace caf {
 namespace crdt {
 
-/// Uri implementation, that supports a scheme and a path.
+/// Uri implementation, that supports a scheme and a path. The uri stores
+/// its string `scheme:/path` in a single buffer and caches its hash.
 class uri : caf::detail::comparable<uri> {
   static constexpr char wildcard = '*';
   static constexpr char path_delim = '/';
@@ -38,86 +44,74 @@ public:
   /// Creates a uri from a string
   /// @param what string that contains a uri
   uri(const std::string& what) {
-    parse(what);
+    parse(what.data(), what.size());
   }
 
   /// Creates a uri from a C-String
   /// @param what C-String that contains a uri
   uri(const char* what) {
-    parse(what);
+    parse(what, std::strlen(what));
   }
 
   /// @returns the scheme of the uri
-  inline const std::string& scheme() const { return scheme_; }
+  inline std::string scheme() const { return buf_.substr(0, sep_); }
 
   /// @returns the path of the uri
-  inline const std::string& path() const { return path_; }
+  inline std::string path() const { return buf_.substr(sep_ + 2); }
 
   /// @returns the string of the uri
-  inline std::string to_string() const { return scheme_ + ":/" + path_; }
+  inline const std::string& to_string() const { return buf_; }
+
+  /// @returns the cached hash of the uri
+  inline size_t hash() const { return hash_; }
 
   /// @returns `true` if a valid uri is loaded otherwise `false`.
-  inline bool valid() const { return !path_.empty() && !scheme_.empty(); }
+  inline bool valid() const { return sep_ > 0 && buf_.size() > sep_ + 2; }
 
   /// @private
   intptr_t compare(const uri& other) const noexcept {
-    return !(path_ == other.path_ && scheme_ == other.scheme_);
+    if (hash_ == other.hash_ && buf_ == other.buf_)
+      return 0;
+    return buf_ < other.buf_ ? -1 : 1;
   }
 
 private:
-  enum class states {
-    parse_scheme,
-    parse_slash,
-    parse_id,
-    parse_end
-  } state_;
-
-  bool consume(char c) {
-    auto check = [&](const states& next, char assumed) {
-      if (c != assumed)
-        return false;
-      state_ = next;
-      return true;
-    };
-    switch(state_) {
-      case states::parse_scheme:
-        if (c == ':')
-          state_ = states::parse_slash;
-        else
-          scheme_ += c;
-        return true;
-      case states::parse_slash:
-        return check(states::parse_id, path_delim);
-      case states::parse_id:
-        path_ += c;
-        if (c == wildcard)
-          state_ = states::parse_end;
-        return true;
-      case states::parse_end:
-        return false;
+  /// Parses `what` in a single pass over a lowercase copy. Parsing stops at
+  /// the first character after a wildcard in the path.
+  void parse(const char* what, size_t size) {
+    buf_.assign(what, size);
+    for (auto& c : buf_)
+      c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    auto colon = buf_.find(':');
+    sep_ = colon == std::string::npos ? buf_.size() : colon;
+    if (sep_ + 1 < buf_.size() && buf_[sep_ + 1] == path_delim) {
+      auto end = buf_.find(wildcard, sep_ + 2);
+      if (end != std::string::npos)
+        buf_.resize(end + 1);
+    } else {
+      buf_.resize(sep_);
+      buf_ += ":/";
     }
-    return false;
+    rehash();
   }
 
-  bool parse(const std::string& what) {
-    state_ = states::parse_scheme;
-    for (size_t i = 0; i < what.size(); ++i) {
-      char c = std::tolower(what[i]);
-      if (!consume(c))
-        return false;
-    }
-    return !scheme_.empty() && !path_.empty();
+  /// @private
+  inline void rehash() {
+    hash_ = std::hash<std::string>{}(buf_);
   }
 
   /// @private
   template <class Processor>
   friend void serialize(Processor& proc, uri& x) {
-    proc & x.path_;
-    proc & x.scheme_;
+    proc & x.buf_;
+    proc & x.sep_;
+    if (!Processor::is_saving::value)
+      x.rehash();
   }
 
-  std::string path_;   /// Path of uri
-  std::string scheme_; /// Scheme of uri
+  std::string buf_ = ":/"; /// String of uri, i.e., `scheme:/path`
+  size_t sep_ = 0;         /// Length of scheme
+  size_t hash_ = std::hash<std::string>{}(":/"); /// Hash of `buf_`
 };
 
 } // namespace crdt
@@ -128,7 +122,7 @@ namespace std {
 template <>
 struct hash<caf::crdt::uri> {
   inline size_t operator()(const caf::crdt::uri& u) const {
-    return hash<std::string>()(u.to_string());
+    return u.hash();
   }
 };
 
@@ -21,8 +21,13 @@
 #define CAF_CRDT_VECTOR_CLOCK_HPP
 
 #include "caf/actor.hpp"
+#include "caf/node_id.hpp"
 
-#include <unordered_map>
+#include "caf/crdt/detail/slot_registry.hpp"
+
+#include <string>
+#include <vector>
+#include <type_traits>
 
 namespace caf {
 namespace crdt {
@@ -36,30 +41,56 @@ enum vector_clock_result {
   concurrent
 };
 
-/// Vector clock implementation for tracking events with vector timestamps
+/// Vector clock implementation for tracking events with vector timestamps.
+/// Slots are interned to small integer ids and stored as a flat array sorted
+/// by id, which allows comparing and merging clocks in one linear pass.
 class vector_clock {
-  /// Internal map type
-  using map_type = std::unordered_map<actor, uint64_t>;
-  /// Iternal value type of map
-  using value_type = typename map_type::value_type;
+  /// Interned id of a slot
+  using slot_id = detail::slot_registry::slot_id;
 
   /// @private
-  vector_clock(map_type&& map) : map_(std::move(map)) {
+  vector_clock(slot_id slot, uint64_t value) : slots_{slot}, values_{value} {
     // nop
   }
 
-  /// @priavte
-  vector_clock(const map_type::key_type& key, map_type::mapped_type& value) {
-    map_.emplace(key, value);
-  }
-
 public:
+  /// Serialized representation of a single slot, interned ids are only valid
+  /// inside a process and are never shipped.
+  struct slot_entry {
+    node_id node;
+    actor_id aid;
+    uint64_t value;
+
+    /// @private
+    template <class Processor>
+    friend void serialize(Processor& proc, slot_entry& x) {
+      proc & x.node;
+      proc & x.aid;
+      proc & x.value;
+    }
+
+    /// @private
+    friend bool operator==(const slot_entry& lhs, const slot_entry& rhs) {
+      return lhs.aid == rhs.aid && lhs.value == rhs.value
+             && lhs.node == rhs.node;
+    }
+  };
+
   /// Default constructor
   vector_clock() = default;
 
   /// Copy constructor
   vector_clock(const vector_clock&) = default;
 
+  /// Move constructor
+  vector_clock(vector_clock&&) = default;
+
+  /// Copy assignment
+  vector_clock& operator=(const vector_clock&) = default;
+
+  /// Move assignment
+  vector_clock& operator=(vector_clock&&) = default;
+
   /// Increments the slot of given actor
   /// @param slot actor handle for key to increment slot
   /// @param delta specifies if the returned state represents the delta or
@@ -67,31 +98,55 @@ public:
   /// @returns vector_clock representing the full clock or delta
   vector_clock increment(const actor& slot, bool delta = false);
 
+  /// Increments the slot of a whole node. The new value is unique for `node`
+  /// and `scope`, which allows all actors on a node to share one slot. The
+  /// number of node slots is bounded by the size of the cluster.
+  /// @param slot node of the slot to increment
+  /// @param scope scope of the event counter, usually a replica id
+  /// @param delta specifies if the returned state represents the delta or
+  ///        the full clock
+  /// @returns vector_clock representing the full clock or delta
+  vector_clock increment(const node_id& slot, const std::string& scope,
+                         bool delta = false);
+
   /// Returns the value of given slot
   /// @param slot actor handle of slot
   /// @returns the value for given slot
   size_t get(const actor& slot) const;
 
+  /// Returns the value of the slot of a whole node
+  /// @param slot node of slot
+  /// @returns the value for given slot
+  size_t get(const node_id& slot) const;
+
   /// Compare two vector clocks and return a value of `vector_clock_result`
   /// @param other `vector_clock` to compare to
-  /// @returns `greater` if `other` is greater                 this < other
+  /// @returns `greater` if `this` is greater                  this > other
   ///          `equal`   if `other` is equal to `this`         this == other
-  ///          `smaller` if `other` is smaller                 this > other
+  ///          `smaller` if `this` is smaller                  this < other
   ///          `concurrent` if there are concurrent events   this || other
   vector_clock_result compare(const vector_clock& other) const;
 
   /// Merges to `other` into `this` and returns the delta
   /// @param other `vector_clock` to merge into `this`
-  /// @returns vector_clock representing the delta
+  /// @returns vector_clock representing the delta
   vector_clock merge(const vector_clock& other);
 
   /// Get the count of all slots (number of events in the clock)
   size_t count() const;
 
+  /// @returns a fingerprint which does not depend on the interned ids
+  uint64_t fingerprint() const;
+
+  /// Drops all slots of retired nodes. Called lazily by `merge` whenever a
+  /// node has been retired since the last compaction.
+  /// @returns `true` if slots have been dropped
+  bool compact();
+
   /// @private
   template <class Processor>
   friend void serialize(Processor& proc, vector_clock& x) {
-    proc & x.map_;
+    x.serialize_impl(proc, typename Processor::is_saving{});
   }
 
   /// @private
@@ -100,9 +155,49 @@ public:
   }
 
 private:
-  size_t count(const actor& slot) const;
+  friend class causal_context;
+
+  /// @private
+  template <class Processor>
+  void serialize_impl(Processor& proc, std::true_type) {
+    auto xs = entries();
+    proc & xs;
+  }
+
+  /// @private
+  template <class Processor>
+  void serialize_impl(Processor& proc, std::false_type) {
+    std::vector<slot_entry> xs;
+    proc & xs;
+    assign(xs);
+  }
+
+  /// @returns the slots of this clock in their serialized representation
+  std::vector<slot_entry> entries() const;
+
+  /// Replaces the content of this clock with `xs`
+  void assign(const std::vector<slot_entry>& xs);
+
+  /// Merges `other` into `this`, keeps the slots of retired nodes unless
+  /// `drop_retired` is set
+  vector_clock merge_impl(const vector_clock& other, bool drop_retired);
+
+  /// Merges `other` whose slots are equal to the slots of `this`
+  vector_clock merge_aligned(const vector_clock& other);
+
+  /// @returns the index of `slot` or the position it would be inserted at
+  size_t lower_bound(slot_id slot) const;
+
+  /// @returns the value of `slot`
+  uint64_t value_of(slot_id slot) const;
+
+  /// Raises the value of `slot` to at least `value`
+  /// @returns the index of `slot`
+  size_t advance(slot_id slot, uint64_t value);
 
-  map_type map_; /// Internal map
+  std::vector<slot_id> slots_;   /// Sorted ids of all slots
+  std::vector<uint64_t> values_; /// Values of all slots, parallel to `slots_`
+  uint64_t generation_ = 0;      /// Registry generation of the last compaction
 };
 
 } // namespace crdt
@@ -32,24 +32,28 @@ constexpr int inc_by   = 10;
 constexpr int number_of_nodes = 2;
 constexpr int expected = nr_spawn * inc_by * number_of_nodes;
 
+// All incrementers of a node share one slot, the counter state holds one
+// entry per node regardless of how many incrementers are spawned.
+using counter = gcounter<int, node_slots>;
+
 class port_dummy : public event_based_actor {
 public:
   using event_based_actor::event_based_actor;
 };
 
-class incrementer : public notifiable<gcounter<int>>::base {
+class incrementer : public notifiable<counter>::base {
 public:
   incrementer(actor_config& cfg)
-    : notifiable<gcounter<int>>::base(cfg),
+    : notifiable<counter>::base(cfg),
       state_(this, "gcounter<int>://counter") {
     // nop
   }
 
 protected:
-  notifiable<gcounter<int>>::behavior_type make_behavior() override {
+  notifiable<counter>::behavior_type make_behavior() override {
     state_.increment_by(inc_by);
     return {
-      [&](notify_atom, const gcounter<int>& t) {
+      [&](notify_atom, const counter& t) {
         state_.merge(t);
         if (state_.count() == expected) {
           aout(this) << "Count is: " << state_.count() << " ==> quit()\n";
@@ -60,13 +64,13 @@ protected:
   }
 
 private:
-  gcounter<int> state_;
+  counter state_;
 };
 
 class config : public crdt_config {
 public:
   config() : crdt_config() {
-    add_crdt<gcounter<int>>("gcounter<int>");
+    add_crdt<counter>("gcounter<int>");
   }
 };
 
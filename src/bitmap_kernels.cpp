@@ -0,0 +1,125 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/config.hpp"
+
+#include "caf/crdt/detail/bitmap_kernels.hpp"
+
+// See clock_kernels.cpp, the vector kernels use per-function target
+// attributes and the library does not require any -m flags.
+#if (defined(CAF_GCC) || defined(CAF_CLANG))                                   \
+    && (defined(__x86_64__) || defined(__i386__))
+#define CAF_CRDT_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+using namespace caf::crdt::detail;
+
+namespace {
+
+// -- scalar -------------------------------------------------------------------
+
+size_t popcount(uint64_t x) {
+#if defined(CAF_GCC) || defined(CAF_CLANG)
+  return static_cast<size_t>(__builtin_popcountll(x));
+#else
+  size_t result = 0;
+  for (; x != 0; x &= x - 1)
+    ++result;
+  return result;
+#endif
+}
+
+size_t merge_scalar(uint64_t* dst, const uint64_t* src, uint64_t* delta,
+                    size_t n) {
+  size_t result = 0;
+  for (size_t i = 0; i < n; ++i) {
+    delta[i] = src[i] & ~dst[i];
+    dst[i] |= src[i];
+    result += popcount(delta[i]);
+  }
+  return result;
+}
+
+size_t count_scalar(const uint64_t* xs, size_t n) {
+  size_t result = 0;
+  for (size_t i = 0; i < n; ++i)
+    result += popcount(xs[i]);
+  return result;
+}
+
+#ifdef CAF_CRDT_X86_KERNELS
+
+// -- AVX2 ---------------------------------------------------------------------
+
+// AVX2 has no vector popcount, the scalar popcnt instruction on the stored
+// words is faster than the nibble lookup for the short bitmaps used here.
+
+__attribute__((target("avx2,popcnt")))
+size_t merge_avx2(uint64_t* dst, const uint64_t* src, uint64_t* delta,
+                  size_t n) {
+  size_t result = 0;
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    auto ptr = reinterpret_cast<__m256i*>(dst + i);
+    auto x = _mm256_loadu_si256(ptr);
+    auto y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(delta + i),
+                        _mm256_andnot_si256(x, y));
+    _mm256_storeu_si256(ptr, _mm256_or_si256(x, y));
+    result += static_cast<size_t>(__builtin_popcountll(delta[i]))
+              + static_cast<size_t>(__builtin_popcountll(delta[i + 1]))
+              + static_cast<size_t>(__builtin_popcountll(delta[i + 2]))
+              + static_cast<size_t>(__builtin_popcountll(delta[i + 3]));
+  }
+  return result + merge_scalar(dst + i, src + i, delta + i, n - i);
+}
+
+__attribute__((target("popcnt")))
+size_t count_popcnt(const uint64_t* xs, size_t n) {
+  size_t result = 0;
+  for (size_t i = 0; i < n; ++i)
+    result += static_cast<size_t>(__builtin_popcountll(xs[i]));
+  return result;
+}
+
+#endif // CAF_CRDT_X86_KERNELS
+
+const bitmap_kernels scalar_kernels{merge_scalar, count_scalar, "scalar"};
+
+const bitmap_kernels& select_kernels() {
+#ifdef CAF_CRDT_X86_KERNELS
+  static const bitmap_kernels avx2{merge_avx2, count_popcnt, "avx2"};
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt"))
+    return avx2;
+#endif
+  return scalar_kernels;
+}
+
+} // namespace <anonymous>
+
+const bitmap_kernels& bitmap_kernels::instance() {
+  static const bitmap_kernels& selected = select_kernels();
+  return selected;
+}
+
+const bitmap_kernels& bitmap_kernels::scalar() {
+  return scalar_kernels;
+}
@@ -0,0 +1,211 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/config.hpp"
+
+#include "caf/crdt/detail/clock_kernels.hpp"
+
+#include <algorithm>
+
+// The vector kernels are compiled with per-function target attributes, the
+// library itself does not require any -m flags.
+#if (defined(CAF_GCC) || defined(CAF_CLANG))                                   \
+    && (defined(__x86_64__) || defined(__i386__))
+#define CAF_CRDT_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+using namespace caf::crdt::detail;
+
+namespace {
+
+/// Number of elements between two checks for an early exit
+constexpr size_t block_size = 64;
+
+// -- scalar -------------------------------------------------------------------
+
+void dominance_scalar(const uint64_t* lhs, const uint64_t* rhs, size_t n,
+                      bool& greater, bool& smaller) {
+  for (size_t i = 0; i < n && !(greater && smaller); ++i) {
+    greater |= lhs[i] > rhs[i];
+    smaller |= lhs[i] < rhs[i];
+  }
+}
+
+size_t count_differ_scalar(const uint64_t* lhs, const uint64_t* rhs,
+                           size_t n) {
+  size_t result = 0;
+  for (size_t i = 0; i < n; ++i)
+    result += lhs[i] != rhs[i] ? 1 : 0;
+  return result;
+}
+
+void join_scalar(uint64_t* lhs, const uint64_t* rhs, size_t n) {
+  for (size_t i = 0; i < n; ++i)
+    lhs[i] = std::max(lhs[i], rhs[i]);
+}
+
+#ifdef CAF_CRDT_X86_KERNELS
+
+// There is no unsigned 64 bit compare before AVX-512, flipping the sign bit
+// maps unsigned order to signed order.
+constexpr long long sign_bit = static_cast<long long>(0x8000000000000000ull);
+
+// -- SSE 4.2 ------------------------------------------------------------------
+
+__attribute__((target("sse4.2")))
+void dominance_sse42(const uint64_t* lhs, const uint64_t* rhs, size_t n,
+                     bool& greater, bool& smaller) {
+  auto bias = _mm_set1_epi64x(sign_bit);
+  auto gt = _mm_setzero_si128();
+  auto lt = _mm_setzero_si128();
+  size_t i = 0;
+  while (i + 2 <= n) {
+    auto end = std::min(n & ~size_t{1}, i + block_size);
+    for (; i < end; i += 2) {
+      auto x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lhs + i));
+      auto y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs + i));
+      x = _mm_xor_si128(x, bias);
+      y = _mm_xor_si128(y, bias);
+      gt = _mm_or_si128(gt, _mm_cmpgt_epi64(x, y));
+      lt = _mm_or_si128(lt, _mm_cmpgt_epi64(y, x));
+    }
+    greater |= _mm_testz_si128(gt, gt) == 0;
+    smaller |= _mm_testz_si128(lt, lt) == 0;
+    if (greater && smaller)
+      return;
+  }
+  dominance_scalar(lhs + i, rhs + i, n - i, greater, smaller);
+}
+
+__attribute__((target("sse4.2,popcnt")))
+size_t count_differ_sse42(const uint64_t* lhs, const uint64_t* rhs,
+                          size_t n) {
+  size_t result = 0;
+  size_t i = 0;
+  for (; i + 2 <= n; i += 2) {
+    auto x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lhs + i));
+    auto y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs + i));
+    auto eq = _mm_movemask_pd(_mm_castsi128_pd(_mm_cmpeq_epi64(x, y)));
+    result += static_cast<size_t>(_mm_popcnt_u32(~eq & 0x3));
+  }
+  return result + count_differ_scalar(lhs + i, rhs + i, n - i);
+}
+
+__attribute__((target("sse4.2")))
+void join_sse42(uint64_t* lhs, const uint64_t* rhs, size_t n) {
+  auto bias = _mm_set1_epi64x(sign_bit);
+  size_t i = 0;
+  for (; i + 2 <= n; i += 2) {
+    auto ptr = reinterpret_cast<__m128i*>(lhs + i);
+    auto x = _mm_loadu_si128(ptr);
+    auto y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs + i));
+    auto mask = _mm_cmpgt_epi64(_mm_xor_si128(y, bias),
+                                _mm_xor_si128(x, bias));
+    _mm_storeu_si128(ptr, _mm_blendv_epi8(x, y, mask));
+  }
+  join_scalar(lhs + i, rhs + i, n - i);
+}
+
+// -- AVX2 ---------------------------------------------------------------------
+
+__attribute__((target("avx2")))
+void dominance_avx2(const uint64_t* lhs, const uint64_t* rhs, size_t n,
+                    bool& greater, bool& smaller) {
+  auto bias = _mm256_set1_epi64x(sign_bit);
+  auto gt = _mm256_setzero_si256();
+  auto lt = _mm256_setzero_si256();
+  size_t i = 0;
+  while (i + 4 <= n) {
+    auto end = std::min(n & ~size_t{3}, i + block_size);
+    for (; i < end; i += 4) {
+      auto x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lhs + i));
+      auto y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rhs + i));
+      x = _mm256_xor_si256(x, bias);
+      y = _mm256_xor_si256(y, bias);
+      gt = _mm256_or_si256(gt, _mm256_cmpgt_epi64(x, y));
+      lt = _mm256_or_si256(lt, _mm256_cmpgt_epi64(y, x));
+    }
+    greater |= _mm256_testz_si256(gt, gt) == 0;
+    smaller |= _mm256_testz_si256(lt, lt) == 0;
+    if (greater && smaller)
+      return;
+  }
+  dominance_scalar(lhs + i, rhs + i, n - i, greater, smaller);
+}
+
+__attribute__((target("avx2,popcnt")))
+size_t count_differ_avx2(const uint64_t* lhs, const uint64_t* rhs,
+                         size_t n) {
+  size_t result = 0;
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    auto x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lhs + i));
+    auto y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rhs + i));
+    auto eq = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(x, y)));
+    result += static_cast<size_t>(_mm_popcnt_u32(~eq & 0xF));
+  }
+  return result + count_differ_scalar(lhs + i, rhs + i, n - i);
+}
+
+__attribute__((target("avx2")))
+void join_avx2(uint64_t* lhs, const uint64_t* rhs, size_t n) {
+  auto bias = _mm256_set1_epi64x(sign_bit);
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    auto ptr = reinterpret_cast<__m256i*>(lhs + i);
+    auto x = _mm256_loadu_si256(ptr);
+    auto y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rhs + i));
+    auto mask = _mm256_cmpgt_epi64(_mm256_xor_si256(y, bias),
+                                   _mm256_xor_si256(x, bias));
+    _mm256_storeu_si256(ptr, _mm256_blendv_epi8(x, y, mask));
+  }
+  join_scalar(lhs + i, rhs + i, n - i);
+}
+
+#endif // CAF_CRDT_X86_KERNELS
+
+const clock_kernels scalar_kernels{dominance_scalar, count_differ_scalar,
+                                   join_scalar, "scalar"};
+
+const clock_kernels& select_kernels() {
+#ifdef CAF_CRDT_X86_KERNELS
+  static const clock_kernels avx2{dominance_avx2, count_differ_avx2,
+                                  join_avx2, "avx2"};
+  static const clock_kernels sse42{dominance_sse42, count_differ_sse42,
+                                   join_sse42, "sse4.2"};
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt"))
+    return avx2;
+  if (__builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("popcnt"))
+    return sse42;
+#endif
+  return scalar_kernels;
+}
+
+} // namespace <anonymous>
+
+const clock_kernels& clock_kernels::instance() {
+  static const clock_kernels& selected = select_kernels();
+  return selected;
+}
+
+const clock_kernels& clock_kernels::scalar() {
+  return scalar_kernels;
+}
@@ -0,0 +1,110 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+
+#include "caf/crdt/dotted_version_vector.hpp"
+
+#include "caf/crdt/detail/digest.hpp"
+
+#include <algorithm>
+
+using namespace caf;
+using namespace caf::crdt;
+
+dot causal_context::next(const node_id& node, const std::string& scope) {
+  auto& reg = detail::slot_registry::instance();
+  auto slot = reg.intern(node);
+  dot result{slot, reg.next_counter(slot, scope)};
+  insert(result);
+  return result;
+}
+
+bool causal_context::contains(const dot& x) const {
+  return x.counter() <= vv_.value_of(x.slot())
+         || std::binary_search(cloud_.begin(), cloud_.end(), x);
+}
+
+void causal_context::insert(const dot& x) {
+  if (contains(x))
+    return;
+  cloud_.insert(std::lower_bound(cloud_.begin(), cloud_.end(), x), x);
+  compact();
+}
+
+bool causal_context::merge(const causal_context& other) {
+  auto res = vv_.compare(other.vv_);
+  bool changed = res == smaller || res == concurrent;
+  // Contexts keep the slots of retired nodes, otherwise the values of these
+  // nodes could neither be overwritten nor told apart from unseen ones
+  if (changed)
+    vv_.merge_impl(other.vv_, false);
+  for (auto& x : other.cloud_) {
+    if (!contains(x)) {
+      cloud_.insert(std::lower_bound(cloud_.begin(), cloud_.end(), x), x);
+      changed = true;
+    }
+  }
+  if (changed)
+    compact();
+  return changed;
+}
+
+uint64_t causal_context::fingerprint() const {
+  // The cloud is sorted by interned ids, hence sum the dots
+  uint64_t cloud = 0;
+  for (auto& x : cloud_)
+    detail::fingerprint_add(cloud, detail::fingerprint(x));
+  return detail::fingerprint_combine(vv_.fingerprint(), cloud);
+}
+
+void causal_context::compact(bool sort) {
+  if (sort) {
+    std::sort(cloud_.begin(), cloud_.end());
+    cloud_.erase(std::unique(cloud_.begin(), cloud_.end()), cloud_.end());
+  }
+  // Sorted by slot and counter, hence the prefix grows in a single pass
+  auto out = cloud_.begin();
+  for (auto& x : cloud_) {
+    auto prefix = vv_.value_of(x.slot());
+    if (x.counter() <= prefix)
+      continue;
+    if (x.counter() == prefix + 1) {
+      vv_.advance(x.slot(), x.counter());
+      continue;
+    }
+    *out++ = x;
+  }
+  cloud_.erase(out, cloud_.end());
+}
+
+vector_clock_result
+dotted_version_vector::compare(const dotted_version_vector& other) const {
+  if (event_ == other.event_)
+    return equal;
+  if (context_.contains(other.event_))
+    return greater;
+  if (other.context_.contains(event_))
+    return smaller;
+  return concurrent;
+}
+
+uint64_t dotted_version_vector::fingerprint() const {
+  return detail::fingerprint_combine(context_.fingerprint(),
+                                     detail::fingerprint(event_));
+}
@@ -0,0 +1,96 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+
+#include "caf/crdt/detail/hash_ring.hpp"
+
+#include "caf/crdt/detail/digest.hpp"
+
+#include <string>
+#include <algorithm>
+
+using namespace caf;
+using namespace caf::crdt;
+using namespace caf::crdt::detail;
+
+namespace {
+
+/// FNV-1a, stable across processes and platforms
+uint64_t stable_hash(const std::string& x) {
+  uint64_t result = 14695981039346656037ull;
+  for (auto c : x) {
+    result ^= static_cast<uint8_t>(c);
+    result *= 1099511628211ull;
+  }
+  return result;
+}
+
+} // namespace <anonymous>
+
+hash_ring::hash_ring(size_t vnodes) : vnodes_{std::max(vnodes, size_t{1})} {
+  // nop
+}
+
+void hash_ring::add(const node_id& node) {
+  if (!nodes_.emplace(node).second)
+    return;
+  auto str = to_string(node);
+  for (size_t i = 0; i < vnodes_; ++i)
+    points_.emplace(point(str, i), node);
+}
+
+void hash_ring::remove(const node_id& node) {
+  if (nodes_.erase(node) == 0)
+    return;
+  auto str = to_string(node);
+  for (size_t i = 0; i < vnodes_; ++i) {
+    auto iter = points_.find(point(str, i));
+    if (iter != points_.end() && iter->second == node)
+      points_.erase(iter);
+  }
+}
+
+bool hash_ring::contains(const node_id& node) const {
+  return nodes_.count(node) > 0;
+}
+
+std::vector<node_id> hash_ring::owners(const uri& id, size_t n) const {
+  std::vector<node_id> result;
+  n = std::min(n, nodes_.size());
+  if (n == 0)
+    return result;
+  auto iter = points_.lower_bound(digest_mix(stable_hash(id.to_string())));
+  do {
+    if (iter == points_.end())
+      iter = points_.begin();
+    if (std::find(result.begin(), result.end(), iter->second) == result.end())
+      result.emplace_back(iter->second);
+    ++iter;
+  } while (result.size() < n);
+  return result;
+}
+
+bool hash_ring::owns(const node_id& node, const uri& id, size_t n) const {
+  auto xs = owners(id, n);
+  return std::find(xs.begin(), xs.end(), node) != xs.end();
+}
+
+uint64_t hash_ring::point(const std::string& node, size_t i) {
+  return digest_mix(stable_hash(node) ^ digest_mix(i + 1));
+}
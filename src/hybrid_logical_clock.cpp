@@ -0,0 +1,99 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/crdt/hybrid_logical_clock.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+
+using namespace caf;
+using namespace caf::crdt;
+
+namespace {
+
+/// Bits of the logical counter
+constexpr int logical_bits = 16;
+
+/// Greatest timestamp issued or observed in this process
+std::atomic<uint64_t> last_time{0};
+
+uint64_t physical_time() {
+  using namespace std::chrono;
+  auto now = system_clock::now().time_since_epoch();
+  auto ms = duration_cast<milliseconds>(now).count();
+  return static_cast<uint64_t>(ms) << logical_bits;
+}
+
+/// Raises `last_time` to at least `x`
+void observe(uint64_t x) {
+  auto last = last_time.load(std::memory_order_relaxed);
+  while (last < x && !last_time.compare_exchange_weak(last, x))
+    ; // nop
+}
+
+/// Hashes `x` with FNV-1a, the result must be equal on all nodes and must
+/// not depend on the standard library in use.
+uint64_t hash_of(const node_id& x) {
+  uint64_t result = 14695981039346656037ull;
+  auto add = [&](uint8_t byte) {
+    result ^= byte;
+    result *= 1099511628211ull;
+  };
+  for (auto byte : x.host_id())
+    add(byte);
+  auto pid = x.process_id();
+  for (int i = 0; i < 4; ++i)
+    add(static_cast<uint8_t>(pid >> (i * 8)));
+  return result;
+}
+
+} // namespace <anonymous>
+
+hybrid_logical_clock hybrid_logical_clock::increment(const node_id& node) {
+  auto pt = physical_time();
+  auto last = last_time.load(std::memory_order_relaxed);
+  uint64_t next;
+  do {
+    // Stay ahead of the physical time, of any timestamp issued or observed
+    // in this process and of the current timestamp of this clock
+    next = std::max(std::max(last, time_) + 1, pt);
+  } while (!last_time.compare_exchange_weak(last, next));
+  time_ = next;
+  node_ = hash_of(node);
+  return *this;
+}
+
+vector_clock_result
+hybrid_logical_clock::compare(const hybrid_logical_clock& other) const {
+  if (time_ != other.time_)
+    return time_ < other.time_ ? smaller : greater;
+  if (node_ != other.node_)
+    return node_ < other.node_ ? smaller : greater;
+  return equal;
+}
+
+hybrid_logical_clock
+hybrid_logical_clock::merge(const hybrid_logical_clock& other) {
+  if (compare(other) != smaller)
+    return {};
+  *this = other;
+  observe(time_);
+  return other;
+}
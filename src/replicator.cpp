@@ -26,6 +26,7 @@
 
 #include "caf/crdt/replicator.hpp"
 
+#include "caf/crdt/detail/timer_wheel.hpp"
 #include "caf/crdt/detail/replicator_callbacks.hpp"
 
 #include <exception>
@@ -35,7 +36,11 @@ using namespace caf;
 using namespace caf::crdt;
 
 void replicator::start() {
-  manager_ = make_replicator_actor(system_);
+  // Replicas look up the wheel when they start, i.e., after the replicator
+  wheel_ = system_.spawn<hidden>(detail::notify_wheel);
+  system_.registry().put(wheel_atom::value,
+                         actor_cast<strong_actor_ptr>(wheel_));
+  manager_ = make_replicator_actor(system_, metrics_);
   system_.registry().put(replicator_atom::value,
                          actor_cast<strong_actor_ptr>(manager_));
 }
@@ -47,13 +52,21 @@ void replicator::stop() {
   self->send_exit(manager_, exit_reason::user_shutdown);
   self->wait_for(manager_);
   destroy(manager_);
+  self->monitor(wheel_);
+  self->send_exit(wheel_, exit_reason::user_shutdown);
+  self->wait_for(wheel_);
+  destroy(wheel_);
 }
 
 void replicator::init(actor_system_config& cfg) {
   cfg.add_hook_type<detail::replicator_callbacks>().
       add_message_type<uri>("uri").
       add_message_type<std::unordered_set<uri>>("unordered_set<uri>").
-      add_message_type<std::vector<message>>("vector<message>");
+      add_message_type<std::vector<message>>("vector<message>").
+      add_message_type<delta_batch>("delta_batch").
+      add_message_type<uri_dictionary>("uri_dictionary").
+      add_message_type<wire_batch>("wire_batch").
+      add_message_type<std::vector<uint64_t>>("vector<uint64_t>");
 }
 
 actor_system::module::id_t replicator::id() const {
@@ -73,8 +86,11 @@ replicator_actor replicator::actor_handle() {
   return manager_;
 }
 
-replicator::replicator(actor_system& sys) : system_(sys),
-                                            manager_{} {
+replicator::replicator(actor_system& sys)
+    : system_(sys),
+      manager_{},
+      wheel_{},
+      metrics_{std::make_shared<flush_metrics>()} {
   // nop
 }
 
@@ -26,32 +26,236 @@
 
 #include "caf/io/middleman.hpp"
 
+#include "caf/crdt/crdt_config.hpp"
+
+#include "caf/crdt/detail/delta_join.hpp"
+#include "caf/crdt/detail/anti_entropy.hpp"
+#include "caf/crdt/detail/slot_registry.hpp"
+#include "caf/crdt/detail/hash_ring.hpp"
+#include "caf/crdt/detail/relay_layer.hpp"
+#include "caf/crdt/detail/gossip_layer.hpp"
+#include "caf/crdt/detail/adaptive_flush.hpp"
 #include "caf/crdt/detail/distribution_layer.hpp"
 
 #include <tuple>
+#include <memory>
+#include <string>
+#include <algorithm>
 #include <vector>
+#include <stdexcept>
 #include <unordered_map>
+#include <unordered_set>
 
 namespace caf {
 namespace crdt {
 
 namespace {
 
+using route_map = detail::route_map;
+
+/// Uris of the ids announced by a node
+using wire_id_map = std::unordered_map<uint32_t, uri>;
+
+/// Owning pointer to the distribution layer of the replicator
+using layer_ptr = std::unique_ptr<detail::abstract_distribution_layer>;
+
+/// Starts a reconciliation round, each replica sends the root of its digest
+/// to the replicas of all intrested nodes
+void reconcile(const std::unordered_map<uri, actor>& states,
+               const route_map& routes) {
+  for (auto& state : states) {
+    auto iter = routes.find(state.first);
+    if (iter != routes.end())
+      anon_send(state.second, digest_atom::value, iter->second);
+  }
+}
+
+/// Set of nodes
+using node_set = std::unordered_set<node_id>;
+
+/// @returns all nodes of `routes`
+node_set nodes_of(const route_map& routes) {
+  node_set result;
+  for (auto& entry : routes)
+    for (auto& hdl : entry.second)
+      result.emplace(hdl.node());
+  return result;
+}
+
+/// Owns the replicas and the delta buffer of a partition of all uris. The
+/// replicator routes all messages of a uri to the shard chosen by its hash,
+/// which keeps the replicator itself free of merge and buffer work.
+class replicator_shard : public event_based_actor {
+public:
+  replicator_shard(actor_config& cfg, replicator_actor parent,
+                   detail::delta_join_map joins, detail::adaptive_flush flush,
+                   size_t notify_interval_ms, size_t notify_min_ms,
+                   size_t notify_max_ms, size_t log_size)
+      : event_based_actor(cfg), parent_{std::move(parent)},
+        sync_{actor_cast<actor>(this), std::move(joins), log_size},
+        flush_{std::move(flush)},
+        notify_interval_ms_{notify_interval_ms},
+        notify_min_ms_{notify_min_ms},
+        notify_max_ms_{notify_max_ms} {
+    // nop
+  }
+
+  const char* name() const override {
+    return "replicator_shard";
+  }
+
+protected:
+  behavior make_behavior() override {
+    return {
+      [&](const uri& id, message& msg) {
+        if (current_sender()->node() == this->node()) {
+          sync_.publish(id, msg); // Add to send buffer
+          flush_.buffered(this, [&] { sync_.flush(); });
+        }
+        return result<void>{forward_to(id, make_message(publish_atom::value,
+                                                        std::move(msg)))};
+      },
+      [&](const uri& id, std::vector<message>& msgs) {
+        return result<void>{forward_to(id, make_message(publish_atom::value,
+                                                        std::move(msgs)))};
+      },
+      [&](forward_atom, const uri& id, message& msg) {
+        return result<void>{forward_to(id, std::move(msg))};
+      },
+      [&](batch_atom, delta_batch& batch) {
+        for (auto& entry : batch) {
+          auto to = find_actor(entry.first);
+          if (to)
+            send(*to, publish_atom::value, std::move(entry.second));
+        }
+      },
+      [&](delta_ack_atom, uint64_t seq) {
+        sync_.ack(current_sender()->node(), seq, states_);
+        report();
+      },
+      [&](unknown_id_atom) {
+        auto sender = actor_cast<actor>(current_sender());
+        send(sender, reannounce_atom::value);
+        sync_.resync(sender.node(), states_);
+      },
+      [&](copy_ack_atom, const uri& id, message& msg) {
+        sync_.state(id, std::move(msg));
+      },
+      [&](delete_replica, const uri& id) {
+        auto res = forward_to(id, make_message(delete_replica::value));
+        states_.erase(id);
+        sync_.remove(id);
+        return result<void>{res};
+      },
+      [&](routes_atom, route_map& routes) {
+        sync_.update(std::move(routes), states_);
+        report();
+      },
+      [&](mark_atom, const node_id& nid) {
+        marks_[nid];
+        sync_.mark(states_);
+        report();
+      },
+      [&](new_connection_atom, const node_id& nid) {
+        marks_.erase(nid);
+      },
+      [&](retire_node_atom, const node_id& nid) {
+        marks_.erase(nid);
+        sync_.remove_peer(nid);
+      },
+      [&](tick_state_atom) {
+        reconcile(states_, sync_.routes());
+      },
+      [&](digest_atom, const uri& id, uint64_t root) {
+        auto iter = states_.find(id);
+        if (iter != states_.end())
+          delegate(iter->second, digest_atom::value, root);
+      },
+      [&](tick_buffer_atom) {
+        flush_.force([&] { sync_.flush(); });
+      },
+      [&](flush_timer_atom) {
+        flush_.timeout(this, [&] { sync_.flush(); });
+      }
+    };
+  }
+
+private:
+  /// Reports each peer which has acknowledged the states of this shard
+  /// since a node was lost to the replicator
+  void report() {
+    if (marks_.empty())
+      return;
+    auto peers = nodes_of(sync_.routes());
+    for (auto& x : marks_)
+      for (auto& peer : peers)
+        if (sync_.marked(peer) && x.second.emplace(peer).second)
+          send(parent_, covered_atom::value, x.first, peer);
+  }
+
+  /// Delegates `msg` to the replica of `id`, spawns the replica if needed
+  expected<unit_t> forward_to(const uri& id, message msg) {
+    auto to = find_actor(id);
+    if (!to)
+      return to.error();
+    delegate(*to, std::move(msg));
+    return unit;
+  }
+
+  /// @returns the replica of `id`, spawns the replica if needed
+  expected<actor> find_actor(const uri& id) {
+    auto iter = states_.find(id);
+    if (iter == states_.end()) {
+      auto args = make_message(id, notify_interval_ms_, notify_min_ms_,
+                               notify_max_ms_);
+      auto opt = system().spawn<actor>(id.scheme(), std::move(args));
+      if (!opt)
+        return make_error(sec::invalid_argument);
+      iter = states_.emplace(id, *opt).first;
+      send(parent_, add_id_atom::value, id);
+    }
+    return iter->second;
+  }
+
+  replicator_actor parent_;                /// Replicator owning this shard
+  detail::anti_entropy sync_;              /// Buffer, delta log and acks
+  detail::adaptive_flush flush_;           /// Decides when to flush
+  std::unordered_map<uri, actor> states_;  /// Maps from uri to replica<T>
+  std::unordered_map<node_id, node_set> marks_; /// Reported peers per node
+  size_t notify_interval_ms_;              /// Notify interval in milliseconds
+  size_t notify_min_ms_;                   /// Lower bound of the interval
+  size_t notify_max_ms_;                   /// Upper bound, 0 fixes it
+};
+
 /// Implementation of replicator actor
 class replicator_actor_impl : public replicator_actor::base {
   using interval_res = std::chrono::milliseconds;
 public:
   replicator_actor_impl(actor_config& cfg, size_t notify_interval_ms,
-                        size_t flush_buffer_interval_ms,
+                        size_t notify_min_ms, size_t notify_max_ms,
+                        detail::adaptive_flush flush,
                         size_t state_interval_ms,
-                        size_t flush_ids_ms)
+                        size_t flush_ids_ms,
+                        detail::delta_join_map joins,
+                        size_t nr_shards, size_t log_size,
+                        size_t gossip_fanout, size_t replication_factor,
+                        size_t vnodes, const std::string& zone)
       : replicator_actor::base(cfg),
-        dist_{this},
+        dist_{make_layer(joins, log_size, gossip_fanout, zone)},
+        joins_{std::move(joins)},
+        nr_shards_{nr_shards},
+        log_size_{log_size},
         notify_interval_ms_{notify_interval_ms},
-        flush_buffer_interval_ms_{flush_buffer_interval_ms},
+        notify_min_ms_{notify_min_ms},
+        notify_max_ms_{notify_max_ms},
+        flush_{std::move(flush)},
         state_interval_ms_{state_interval_ms},
-        flush_ids_ms_{flush_ids_ms} {
-    // nop
+        flush_ids_ms_{flush_ids_ms},
+        replication_factor_{replication_factor},
+        ring_{vnodes} {
+    // Messages of a specific layer go to its concrete type
+    gossip_ = dynamic_cast<detail::gossip_layer*>(dist_.get());
+    relay_ = dynamic_cast<detail::relay_layer*>(dist_.get());
   }
 
   const char* name() const override {
@@ -60,52 +264,259 @@ public:
 
 protected:
   behavior_type make_behavior() override {
-    send(this, tick_buffer_atom::value);
-    send(this, tick_state_atom::value);
     send(this, tick_ids_atom::value);
+    delayed_send(this, interval_res(state_interval_ms_),
+                 tick_state_atom::value);
+    ring_.add(node());
+    // With a single shard, this actor owns all replicas itself
+    if (nr_shards_ > 1)
+      for (size_t i = 0; i < nr_shards_; ++i)
+        shards_.emplace_back(spawn<replicator_shard, linked>(
+          actor_cast<replicator_actor>(this), joins_, flush_,
+          notify_interval_ms_, notify_min_ms_, notify_max_ms_, log_size_));
     return {
       // ---
       [&](const uri& id, message& msg) {
-        if (current_sender()->node() == this->node())
-          dist_.publish(id, msg); // Add to send buffer
+        if (!shards_.empty())
+          return result<void>{delegate_to_shard(id, id, std::move(msg))};
+        if (current_sender()->node() == this->node()) {
+          auto owner = foreign_owner(id);
+          if (owner) {
+            send(owner, publish_atom::value, id, std::move(msg));
+            return result<void>{unit};
+          }
+          dist_->publish(id, msg); // Add to send buffer
+          flush_.buffered(this, [&] { dist_->flush_buffer(); });
+        }
         return result<void>{delegate_to<unit_t>(id, publish_atom::value,
                             std::move(msg))};
       },
+      [&](publish_atom, const uri& id, message& msg) {
+        // A write of a node which does not own `id`, never forwarded again
+        // since rings of both nodes may differ for a moment
+        dist_->publish(id, msg);
+        flush_.buffered(this, [&] { dist_->flush_buffer(); });
+        auto to = find_actor(id);
+        if (to)
+          send(*to, publish_atom::value, std::move(msg));
+      },
+      [&](forward_atom, const uri& id, message& msg) {
+        // A request of a node which does not own `id`
+        auto to = find_actor(id);
+        if (to)
+          delegate(*to, std::move(msg));
+      },
+      [&](handoff_atom, const uri& id, message& msg) {
+        // The previous owner has published this state already, merge it
+        // into the local replica only
+        auto to = find_actor(id);
+        if (!to)
+          return;
+        send(*to, publish_atom::value, std::move(msg));
+        send(actor_cast<actor>(current_sender()), handoff_ack_atom::value, id);
+      },
+      [&](handoff_ack_atom, const uri& id) {
+        auto iter = handoffs_.find(id);
+        if (iter == handoffs_.end())
+          return;
+        auto& x = iter->second;
+        if (x.unacked.erase(current_sender()->node()) > 0)
+          x.heir = actor_cast<replicator_actor>(current_sender());
+        settle(id);
+      },
       [&](const uri& id, std::vector<message>& msgs) {
+        if (!shards_.empty())
+          return result<void>{delegate_to_shard(id, id, std::move(msgs))};
         return result<void>{delegate_to<unit_t>(id, publish_atom::value,
                             std::move(msgs))};
       },
+      [&](batch_atom, uint64_t seq, uri_dictionary& dict, wire_batch& xs) {
+        auto sender = actor_cast<actor>(current_sender());
+        // The sender resends all batches after confirming the announcement
+        if (reannounce_.count(sender) > 0)
+          return;
+        delta_batch batch;
+        if (!decode(dict, xs, batch)) {
+          // Never acknowledge a batch which cannot be applied as a whole
+          reannounce_.emplace(sender);
+          send(sender, unknown_id_atom::value);
+          return;
+        }
+        // Batches arrive in order, acknowledge them before dispatching
+        send(sender, delta_ack_atom::value, seq);
+        if (relay_) {
+          // The relay of a zone passes deltas of other zones on
+          auto n = relay_->pass_on(current_sender()->node(), batch);
+          if (n > 0)
+            flush_.buffered(this, [&] { dist_->flush_buffer(); }, n);
+        }
+        if (!shards_.empty()) {
+          // Split the batch along the shards owning its uris
+          std::vector<delta_batch> parts(shards_.size());
+          for (auto& entry : batch)
+            parts[shard_index(entry.first)].emplace(entry.first,
+                                                    std::move(entry.second));
+          for (size_t i = 0; i < parts.size(); ++i)
+            if (!parts[i].empty())
+              send(shards_[i], batch_atom::value, std::move(parts[i]));
+          return;
+        }
+        for (auto& entry : batch) {
+          auto to = find_actor(entry.first);
+          if (to)
+            send(*to, publish_atom::value, std::move(entry.second));
+        }
+      },
+      [&](gossip_atom, const node_id& origin, uint64_t seq, uint32_t ttl,
+          uri_dictionary& dict, wire_batch& xs) {
+        delta_batch batch;
+        decode(dict, xs, batch);
+        if (!gossip_ || !gossip_->rumor(origin, seq, ttl, batch))
+          return;
+        // Rumors also pass nodes which have no replica for some uris
+        for (auto& entry : batch) {
+          auto iter = states_.find(entry.first);
+          if (iter != states_.end())
+            send(iter->second, publish_atom::value, std::move(entry.second));
+        }
+      },
+      [&](zone_atom, const std::string& label) {
+        if (!relay_)
+          return;
+        relay_->zone(current_sender()->node(), label);
+        dist_->sync(states_);
+      },
+      [&](unknown_id_atom) {
+        auto sender = actor_cast<actor>(current_sender());
+        send(sender, reannounce_atom::value);
+        dist_->resync(sender.node(), states_);
+      },
+      [&](reannounce_atom) {
+        reannounce_.erase(actor_cast<actor>(current_sender()));
+      },
+      [&](delta_ack_atom, uint64_t seq) {
+        dist_->ack(current_sender()->node(), seq, states_);
+        progress();
+      },
       [&](tick_state_atom) {
-        // All states have to send their state to the replicator
-        for (auto& state : states_)
-          anon_send(state.second, copy_atom::value);
+        for (auto& shard : shards_)
+          send(shard, tick_state_atom::value);
+        if (shards_.empty())
+          reconcile(states_, dist_->routes());
         delayed_send(this, interval_res(state_interval_ms_),
                      tick_state_atom::value);
       },
+      [&](digest_atom, const uri& id, uint64_t root) {
+        // Digests never spawn a replica, nodes without one have no interest
+        if (!shards_.empty()) {
+          delegate_to_shard(id, digest_atom::value, id, root);
+          return;
+        }
+        auto iter = states_.find(id);
+        if (iter != states_.end())
+          delegate(iter->second, digest_atom::value, root);
+      },
       [&](copy_ack_atom, uri& id, message& msg) {
-        dist_.publish(std::move(id), std::move(msg));
+        if (!shards_.empty()) {
+          delegate_to_shard(id, copy_ack_atom::value, id, std::move(msg));
+          return;
+        }
+        dist_->state(id, msg);
+        if (handoffs_.count(id) > 0)
+          hand_off(id, msg);
       },
       [&](tick_ids_atom) {
-        dist_.pull_ids();
+        dist_->push_ids();
         delayed_send(this, interval_res(flush_ids_ms_), tick_ids_atom::value);
       },
       [&](tick_buffer_atom) {
-        dist_.flush_buffer();
-        delayed_send(this, interval_res(flush_buffer_interval_ms_),
-                     tick_buffer_atom::value);
+        for (auto& shard : shards_)
+          send(shard, tick_buffer_atom::value);
+        flush_.force([&] { dist_->flush_buffer(); });
+      },
+      [&](flush_timer_atom) {
+        flush_.timeout(this, [&] { dist_->flush_buffer(); });
       },
       // ---
       [&](new_connection_atom, const node_id& node) {
-        dist_.add_new_node(node);
+        if (lost_.erase(node) > 0)
+          for (auto& shard : shards_)
+            send(shard, new_connection_atom::value, node);
+        dist_->add_new_node(node);
+        if (replication_factor_ > 0 && dist_->replicator_of(node)) {
+          ring_.add(node);
+          rebalance();
+        }
       },
       [&](connection_lost_atom, const node_id& nid) {
-        dist_.remove_node(nid);
+        dist_->remove_node(nid);
+        wire_ids_.erase(nid);
+        for (auto i = reannounce_.begin(); i != reannounce_.end();)
+          if (i->node() == nid)
+            i = reannounce_.erase(i);
+          else
+            ++i;
+        // Lost owners never acknowledge, the ring picks their successors
+        for (auto& x : handoffs_) {
+          auto& to = x.second.to;
+          to.erase(std::remove_if(to.begin(), to.end(),
+                                  [&](const replicator_actor& hdl) {
+                                    return hdl.node() == nid;
+                                  }),
+                   to.end());
+          x.second.unacked.erase(nid);
+        }
+        if (ring_.contains(nid)) {
+          ring_.remove(nid);
+          rebalance();
+        }
+        std::vector<uri> ids;
+        for (auto& x : handoffs_)
+          ids.emplace_back(x.first);
+        for (auto& id : ids)
+          settle(id);
+        push_routes();
+        dist_->sync(states_);
+        // All live peers receive the full states of this node again, the
+        // slots of `nid` retire once they cover each other
+        if (lost_.count(nid) == 0) {
+          if (!shards_.empty()) {
+            lost_[nid];
+            for (auto& shard : shards_)
+              send(shard, mark_atom::value, nid);
+          } else if (dist_->mark(states_)) {
+            lost_[nid];
+          }
+        }
+        progress();
+      },
+      [&](covered_atom, const node_id& nid) {
+        covered_[nid].emplace(current_sender()->node());
+        progress();
+      },
+      [&](covered_atom, const node_id& nid, const node_id& peer) {
+        shipped(nid, peer);
+        progress();
       },
       [&](get_ids_atom, size_t seen) {
-        dist_.get_ids(current_sender()->node(), seen);
+        dist_->get_ids(current_sender()->node(), seen);
       },
       [&](size_t version, std::unordered_set<uri>& ids) {
-        dist_.update(current_sender()->node(), version, std::move(ids));
+        dist_->update(current_sender()->node(), version, std::move(ids));
+        push_routes();
+        dist_->sync(states_);
+        progress();
+      },
+      [&](ids_delta_atom, size_t base, size_t version,
+          const std::unordered_set<uri>& added,
+          const std::unordered_set<uri>& removed) {
+        dist_->update(current_sender()->node(), base, version, added, removed);
+        push_routes();
+        dist_->sync(states_);
+        progress();
+      },
+      [&](add_id_atom, const uri& id) {
+        dist_->add_id(id);
       },
       // --- Subscribe & Unsubscribe
       [&](subscribe_atom, const uri& id) {
@@ -118,33 +529,33 @@ protected:
       [&](read_all_atom, const uri& id) {
         return result<read_succeed_atom>{
                  delegate_to<read_succeed_atom>(id, read_all_atom::value, id,
-                            dist_.get_intrested(id))
+                            dist_->get_intrested(id))
                };
       },
       [&](read_k_atom, size_t k, const uri& id) {
         return result<read_succeed_atom>{
                  delegate_to<read_succeed_atom>(id, read_k_atom::value, id,
-                            dist_.get_intrested(id), k)
+                            dist_->get_intrested(id), k)
           };
       },
       [&](read_majority_atom, const uri& id) {
         return result<read_succeed_atom>{
                  delegate_to<read_succeed_atom>(id, read_majority_atom::value, id,
-                            dist_.get_intrested(id))
+                            dist_->get_intrested(id))
                };
       },
       [&](read_local_atom, const uri& id) {
         return result<void>{delegate_to<unit_t>(id, read_local_atom::value)};
       },
       [&](write_all_atom, const uri& id, const message& msg) {
-        auto intest = dist_.get_intrested(id);
+        auto intest = dist_->get_intrested(id);
         return result<write_succeed_atom>{
                  delegate_to<write_succeed_atom>(id, write_all_atom::value, id,
                             std::move(intest), msg)
                };
       },
       [&](write_k_atom, size_t k, const uri& id, const message& msg) {
-        auto intrest = dist_.get_intrested(id);
+        auto intrest = dist_->get_intrested(id);
         return result<write_succeed_atom>{
                  delegate_to<write_succeed_atom>(id, write_all_atom::value, id,
                             std::move(intrest), msg, k)
@@ -153,7 +564,7 @@ protected:
       [&](write_majority_atom, const uri& id, const message& msg) {
         return result<write_succeed_atom>{
                  delegate_to<write_succeed_atom>(id, write_majority_atom::value, id,
-                            dist_.get_intrested(id), msg)
+                            dist_->get_intrested(id), msg)
                };
       },
       [&](write_local_atom, const uri& id, const message& msg) {
@@ -163,17 +574,62 @@ protected:
                };
       },
       [&](delete_replica, const uri& id) {
+        if (!shards_.empty())
+          return result<void>{delegate_to_shard(id, delete_replica::value, id)};
         auto res = delegate_to<unit_t>(id, delete_replica::value);
         states_.erase(id);
+        dist_->drop_state(id);
         return result<void>{res};
       }
     };
   }
 
 private:
+  /// @returns a gossip layer if `gossip_fanout` is set, a relay layer if
+  ///          `zone` is set, a layer shipping deltas to all intrested nodes
+  ///          otherwise
+  layer_ptr make_layer(const detail::delta_join_map& joins, size_t log_size,
+                       size_t gossip_fanout, const std::string& zone) {
+    if (gossip_fanout > 0)
+      return layer_ptr{new detail::gossip_layer(this, joins, gossip_fanout)};
+    if (!zone.empty())
+      return layer_ptr{new detail::relay_layer(this, joins, log_size, zone)};
+    return layer_ptr{new detail::distribution_layer(this, joins, log_size)};
+  }
+
+  /// Adopts the ids announced by the sender in `dict` and decodes `xs`
+  /// into `result`
+  /// @returns `false` if the sender never announced an id of `xs`
+  bool decode(uri_dictionary& dict, wire_batch& xs, delta_batch& result) {
+    auto& ids = wire_ids_[current_sender()->node()];
+    for (auto& entry : dict)
+      ids[entry.first] = std::move(entry.second);
+    auto complete = true;
+    for (auto& entry : xs) {
+      auto iter = ids.find(entry.first);
+      if (iter != ids.end())
+        result.emplace(iter->second, std::move(entry.second));
+      else
+        complete = false;
+    }
+    return complete;
+  }
 
   template <class R, class... Ts>
   expected<R> delegate_to(const uri& id, Ts&&... ts) {
+    auto owner = foreign_owner(id);
+    if (owner) {
+      // The owner delegates to its replica, which answers the sender
+      delegate(owner, forward_atom::value, id,
+               make_message(std::forward<Ts>(ts)...));
+      return R{};
+    }
+    if (!shards_.empty()) {
+      // The shard spawns the replica and reports errors to the sender
+      delegate(shard_of(id), forward_atom::value, id,
+               make_message(std::forward<Ts>(ts)...));
+      return R{};
+    }
     auto to = find_actor(id);
     if (to) {
       delegate(*to, std::forward<Ts>(ts)...);
@@ -182,35 +638,275 @@ private:
     return to.error();
   }
 
+  /// Delegates a message as is to the shard owning `id`
+  template <class... Ts>
+  expected<unit_t> delegate_to_shard(const uri& id, Ts&&... ts) {
+    delegate(shard_of(id), std::forward<Ts>(ts)...);
+    return unit;
+  }
+
+  /// @returns the index of the shard owning `id`
+  size_t shard_index(const uri& id) const {
+    return std::hash<uri>{}(id) % shards_.size();
+  }
+
+  /// @returns the shard owning `id`
+  const actor& shard_of(const uri& id) const {
+    return shards_[shard_index(id)];
+  }
+
+  /// Sends the current routes of all uris to the shards
+  void push_routes() {
+    if (shards_.empty())
+      return;
+    auto routes = dist_->routes();
+    for (auto& shard : shards_)
+      send(shard, routes_atom::value, routes);
+  }
+
+  // -- Retirement of lost nodes -----------------------------------------------
+
+  /// @private
+  struct retirement {
+    std::unordered_map<node_id, size_t> shipped; /// Parts done per peer
+    node_set covering;                           /// Peers told they cover us
+  };
+
+  /// Counts that a shard, or this actor without shards, has shipped its
+  /// states to `peer` since `nid` was lost. Tells `peer` once all did.
+  void shipped(const node_id& nid, const node_id& peer) {
+    auto iter = lost_.find(nid);
+    if (iter == lost_.end())
+      return;
+    auto& x = iter->second;
+    auto parts = std::max(shards_.size(), size_t{1});
+    if (x.covering.count(peer) > 0 || ++x.shipped[peer] < parts)
+      return;
+    x.covering.emplace(peer);
+    auto hdl = dist_->replicator_of(peer);
+    if (hdl)
+      send(hdl, covered_atom::value, nid);
+  }
+
+  /// Retires the slots of all lost nodes which are causally stable, i.e.,
+  /// each live peer has acknowledged the states of this node and this node
+  /// has acknowledged the states of each live peer since losing the node.
+  /// Until then, a partitioned peer may still hold updates of a lost node.
+  void progress() {
+    if (lost_.empty())
+      return;
+    auto peers = nodes_of(dist_->routes());
+    if (shards_.empty())
+      for (auto& x : lost_)
+        for (auto& peer : peers)
+          if (dist_->marked(peer))
+            shipped(x.first, peer);
+    std::vector<node_id> stable;
+    for (auto& x : lost_) {
+      auto& covered = covered_[x.first];
+      auto covers = [&](const node_id& peer) {
+        return x.second.covering.count(peer) > 0 && covered.count(peer) > 0;
+      };
+      if (std::all_of(peers.begin(), peers.end(), covers))
+        stable.emplace_back(x.first);
+    }
+    for (auto& nid : stable) {
+      lost_.erase(nid);
+      covered_.erase(nid);
+      detail::slot_registry::instance().retire(nid);
+      dist_->retire_node(nid);
+      for (auto& shard : shards_)
+        send(shard, retire_node_atom::value, nid);
+    }
+  }
+
   expected<actor> find_actor(const uri& id) {
     auto iter = states_.find(id);
     if (iter == states_.end()) {
-      auto args = make_message(id, notify_interval_ms_);
+      auto args = make_message(id, notify_interval_ms_, notify_min_ms_,
+                               notify_max_ms_);
       auto opt = system().spawn<actor>(id.scheme(), std::move(args));
       if (!opt)
         return {sec::invalid_argument};
       iter = states_.emplace(id, *opt).first;
-      dist_.add_id(id);
+      dist_->add_id(id);
+      if (replication_factor_ > 0)
+        owners_[id] = ring_.owners(id, replication_factor_);
     }
     return iter->second;
   }
 
+  // -- Partial replication ----------------------------------------------------
+
+  /// @private
+  struct handoff {
+    std::vector<replicator_actor> to;    /// New owners waiting for the state
+    std::unordered_set<node_id> unacked; /// New owners which got the state
+    replicator_actor heir;               /// Owner which has the state
+    bool keep = false;                   /// This node still owns the uri
+  };
+
+  /// @returns the replicator of an owner of `id` if this node does not own
+  ///          `id`, an invalid handle if it does or replicates fully
+  replicator_actor foreign_owner(const uri& id) const {
+    if (replication_factor_ == 0)
+      return {};
+    auto owners = ring_.owners(id, replication_factor_);
+    if (std::find(owners.begin(), owners.end(), node()) != owners.end())
+      return {};
+    for (auto& owner : owners) {
+      auto hdl = dist_->replicator_of(owner);
+      if (hdl)
+        return hdl;
+    }
+    return {};
+  }
+
+  /// The ring has changed, each replica with new owners sends its state to
+  /// them. Replicas of uris this node no longer owns are dropped once the
+  /// new owners have acknowledged the state, their subscribers move along.
+  void rebalance() {
+    for (auto& state : states_) {
+      auto owners = ring_.owners(state.first, replication_factor_);
+      auto& before = owners_[state.first];
+      handoff x;
+      for (auto& owner : owners) {
+        if (owner == node()) {
+          x.keep = true;
+          continue;
+        }
+        auto hdl = dist_->replicator_of(owner);
+        if (!hdl)
+          continue;
+        if (std::find(before.begin(), before.end(), owner) == before.end())
+          x.to.emplace_back(std::move(hdl));
+        else if (!x.heir)
+          x.heir = std::move(hdl); // Has replicated the state all along
+      }
+      before = std::move(owners);
+      if (x.keep && x.to.empty())
+        continue;
+      auto& pending = handoffs_[state.first];
+      pending.to.insert(pending.to.end(), x.to.begin(), x.to.end());
+      pending.keep = x.keep;
+      if (!pending.heir)
+        pending.heir = std::move(x.heir);
+      send(state.second, copy_atom::value);
+    }
+  }
+
+  /// Ships the state of `id` to its new owners, which acknowledge it
+  void hand_off(const uri& id, const message& msg) {
+    auto& x = handoffs_[id];
+    for (auto& hdl : x.to) {
+      send(hdl, handoff_atom::value, id, msg);
+      x.unacked.emplace(hdl.node());
+    }
+    x.to.clear();
+    settle(id);
+  }
+
+  /// Finishes the hand off of `id` once all new owners have acknowledged
+  /// it. Without any owner holding the state, this node keeps its replica.
+  void settle(const uri& id) {
+    auto iter = handoffs_.find(id);
+    if (iter == handoffs_.end() || !iter->second.to.empty()
+        || !iter->second.unacked.empty())
+      return;
+    auto x = std::move(iter->second);
+    handoffs_.erase(iter);
+    if (x.keep || !x.heir)
+      return;
+    auto i = states_.find(id);
+    if (i == states_.end())
+      return;
+    send(i->second, delete_replica::value, x.heir);
+    states_.erase(i);
+    owners_.erase(id);
+    dist_->remove_id(id);
+    dist_->drop_state(id);
+  }
+
   std::unordered_map<uri, actor> states_; /// Maps from uri to replica<T>
-  detail::distribution_layer dist_;       /// Organize dist_ribution of updates
+  std::unordered_map<node_id, retirement> lost_; /// Pending retirements
+  std::unordered_map<node_id, node_set> covered_; /// Peers covered per node
+  std::unordered_map<node_id, wire_id_map> wire_ids_; /// Announced ids
+  std::unordered_set<actor> reannounce_; /// Senders to announce ids again
+  layer_ptr dist_;                        /// Organize dist_ribution of updates
+  detail::gossip_layer* gossip_;          /// `dist_` in gossip mode
+  detail::relay_layer* relay_;            /// `dist_` in zone mode
+  detail::delta_join_map joins_;          /// Joins of buffered deltas
+  size_t nr_shards_;                      /// Number of shards
+  size_t log_size_;                       /// Retained delta groups
+  std::vector<actor> shards_;             /// Shards owning the replicas
   size_t notify_interval_ms_;             /// Notify interval in milliseconds
-  size_t flush_buffer_interval_ms_;       /// Flush interval in milliseconds
+  size_t notify_min_ms_;                  /// Lower bound of the interval
+  size_t notify_max_ms_;                  /// Upper bound, 0 fixes it
+  detail::adaptive_flush flush_;          /// Decides when to flush
   size_t state_interval_ms_;              /// State interval in milliseconds
   size_t flush_ids_ms_;                   /// Replic-ID reconciliation interval
+  size_t replication_factor_;             /// Owners per uri, 0 replicates all
+  detail::hash_ring ring_;                /// Places uris on owners
+  std::unordered_map<uri, std::vector<node_id>> owners_; /// Of local uris
+  std::unordered_map<uri, handoff> handoffs_; /// States on their way
 };
 
 } // namespace <anonymous>
 
-replicator_actor make_replicator_actor(actor_system& sys) {
+replicator_actor
+make_replicator_actor(actor_system& sys,
+                      std::shared_ptr<flush_metrics> metrics) {
+  // Joins, shards and flush thresholds are only known if crdt_config
+  // configured the system
+  detail::delta_join_map joins;
+  size_t nr_shards = 1;
+  size_t log_size = 64;
+  size_t gossip_fanout = 0;
+  size_t replication_factor = 0;
+  size_t vnodes = 64;
+  std::string zone;
+  size_t notify_min_ms = 0;
+  size_t notify_max_ms = 0;
+  size_t max_deltas = 0;
+  size_t idle_ms = 0;
+  auto cfg = dynamic_cast<const crdt_config*>(&sys.config());
+  if (cfg) {
+    joins = cfg->crdt_delta_joins;
+    nr_shards = cfg->crdt_replicator_shards;
+    log_size = cfg->crdt_delta_log_size;
+    gossip_fanout = cfg->crdt_gossip_fanout;
+    replication_factor = cfg->crdt_replication_factor;
+    vnodes = cfg->crdt_virtual_nodes;
+    zone = cfg->crdt_zone;
+    notify_min_ms = cfg->crdt_notify_min_ms;
+    notify_max_ms = cfg->crdt_notify_max_ms;
+    // Rumors, relayed deltas and hand-offs pass the replicator, shards
+    // would bypass them. The setters already reject this combination, this
+    // catches fields set directly.
+    auto conflict = cfg->shards_conflict();
+    if (!conflict.empty())
+      throw std::invalid_argument(conflict);
+    max_deltas = cfg->crdt_flush_max_deltas;
+    idle_ms = cfg->crdt_flush_idle_ms;
+  }
+  using std::chrono::milliseconds;
+  detail::adaptive_flush flush{
+    max_deltas, milliseconds(sys.config().crdt_flush_buffer_interval_ms),
+    milliseconds(idle_ms), std::move(metrics)};
   return sys.spawn<replicator_actor_impl, hidden>(
     sys.config().crdt_notify_interval_ms,
-    sys.config().crdt_flush_buffer_interval_ms,
+    notify_min_ms,
+    notify_max_ms,
+    std::move(flush),
     sys.config().crdt_state_interval_ms,
-    sys.config().crdt_ids_interval_ms
+    sys.config().crdt_ids_interval_ms,
+    std::move(joins),
+    nr_shards,
+    log_size,
+    gossip_fanout,
+    replication_factor,
+    vnodes,
+    zone
   );
 }
 
@@ -0,0 +1,587 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/config.hpp"
+
+#include "caf/crdt/detail/roaring_bitmap.hpp"
+
+#include "caf/crdt/detail/bitmap_kernels.hpp"
+
+#include <iterator>
+#include <algorithm>
+
+using namespace caf::crdt::detail;
+
+namespace {
+
+using block = roaring_bitmap::block;
+
+/// Number of values per block
+constexpr uint32_t block_size = 1u << 16;
+
+/// Number of words of a bitmap container
+constexpr size_t bitmap_words = block_size / 64;
+
+/// Array containers above this size are larger than a bitmap container
+constexpr uint32_t max_array = 4096;
+
+size_t popcount(uint64_t x) {
+#if defined(CAF_GCC) || defined(CAF_CLANG)
+  return static_cast<size_t>(__builtin_popcountll(x));
+#else
+  size_t result = 0;
+  for (; x != 0; x &= x - 1)
+    ++result;
+  return result;
+#endif
+}
+
+/// @returns the index of the lowest set bit, requires `x != 0`
+uint32_t lowest_bit(uint64_t x) {
+#if defined(CAF_GCC) || defined(CAF_CLANG)
+  return static_cast<uint32_t>(__builtin_ctzll(x));
+#else
+  uint32_t result = 0;
+  for (; (x & 1) == 0; x >>= 1)
+    ++result;
+  return result;
+#endif
+}
+
+uint64_t key_of(uint64_t x) {
+  return x >> 16;
+}
+
+uint16_t low_of(uint64_t x) {
+  return static_cast<uint16_t>(x & 0xFFFF);
+}
+
+// -- run containers store pairs of start and length minus one -----------------
+
+size_t runs(const block& b) {
+  return b.values.size() / 2;
+}
+
+uint32_t run_start(const block& b, size_t i) {
+  return b.values[2 * i];
+}
+
+uint32_t run_last(const block& b, size_t i) {
+  return uint32_t{b.values[2 * i]} + b.values[2 * i + 1];
+}
+
+/// @returns the index of the run containing `low` or `runs(b)`
+size_t find_run(const block& b, uint32_t low) {
+  size_t first = 0;
+  size_t last = runs(b);
+  while (first < last) {
+    auto mid = first + (last - first) / 2;
+    if (run_last(b, mid) < low)
+      first = mid + 1;
+    else
+      last = mid;
+  }
+  return first < runs(b) && run_start(b, first) <= low ? first : runs(b);
+}
+
+// -- conversions --------------------------------------------------------------
+
+bool test_bit(const uint64_t* words, uint32_t low) {
+  return (words[low / 64] >> (low % 64)) & 1;
+}
+
+void set_bit(uint64_t* words, uint32_t low) {
+  words[low / 64] |= uint64_t{1} << (low % 64);
+}
+
+/// Sets the bits of all values of `b` in `words`
+void fill_bits(const block& b, uint64_t* words) {
+  switch (b.type) {
+    case roaring_bitmap::array_block:
+      for (auto x : b.values)
+        set_bit(words, x);
+      break;
+    case roaring_bitmap::bitmap_block:
+      std::copy(b.bits.begin(), b.bits.end(), words);
+      break;
+    default:
+      for (size_t i = 0; i < runs(b); ++i)
+        for (auto x = run_start(b, i); x <= run_last(b, i); ++x)
+          set_bit(words, x);
+  }
+}
+
+void to_bitmap(block& b) {
+  if (b.type == roaring_bitmap::bitmap_block)
+    return;
+  std::vector<uint64_t> words(bitmap_words);
+  fill_bits(b, words.data());
+  b.bits.swap(words);
+  b.values.clear();
+  b.values.shrink_to_fit();
+  b.type = roaring_bitmap::bitmap_block;
+}
+
+/// Converts `b` to an array container, requires `b.card <= max_array`
+void to_array(block& b) {
+  if (b.type == roaring_bitmap::array_block)
+    return;
+  std::vector<uint16_t> xs;
+  xs.reserve(b.card);
+  if (b.type == roaring_bitmap::bitmap_block) {
+    for (size_t i = 0; i < bitmap_words; ++i)
+      for (auto w = b.bits[i]; w != 0; w &= w - 1)
+        xs.push_back(static_cast<uint16_t>(i * 64 + lowest_bit(w)));
+  } else {
+    for (size_t i = 0; i < runs(b); ++i)
+      for (auto x = run_start(b, i); x <= run_last(b, i); ++x)
+        xs.push_back(static_cast<uint16_t>(x));
+  }
+  b.values.swap(xs);
+  b.bits.clear();
+  b.bits.shrink_to_fit();
+  b.type = roaring_bitmap::array_block;
+}
+
+/// Converts a run container into an array or bitmap container
+void materialize(block& b) {
+  if (b.type != roaring_bitmap::run_block)
+    return;
+  if (b.card <= max_array)
+    to_array(b);
+  else
+    to_bitmap(b);
+}
+
+/// Picks the array or bitmap container depending on the cardinality
+void settle(block& b) {
+  if (b.card <= max_array)
+    to_array(b);
+  else
+    to_bitmap(b);
+}
+
+/// Converts `b` into the container with the smallest serialized size
+void optimize_block(block& b) {
+  materialize(b);
+  std::vector<uint16_t> rs;
+  auto emit = [&](uint32_t start, uint32_t last) {
+    rs.push_back(static_cast<uint16_t>(start));
+    rs.push_back(static_cast<uint16_t>(last - start));
+  };
+  // Count runs first, most blocks do not qualify and need no allocation
+  size_t n = 0;
+  if (b.type == roaring_bitmap::array_block) {
+    for (size_t i = 0; i < b.values.size(); ++i)
+      if (i == 0 || b.values[i] != b.values[i - 1] + 1)
+        ++n;
+  } else {
+    uint64_t prev = 0; // Highest bit of the previous word
+    for (auto w : b.bits) {
+      // A run starts at every set bit whose predecessor is not set
+      n += popcount(w & ~((w << 1) | prev));
+      prev = w >> 63;
+    }
+  }
+  auto run_bytes = n * 4;
+  auto other_bytes = b.type == roaring_bitmap::array_block
+                     ? size_t{b.card} * 2
+                     : bitmap_words * 8;
+  if (run_bytes >= other_bytes)
+    return;
+  rs.reserve(n * 2);
+  bool open = false;
+  uint32_t start = 0;
+  uint32_t last = 0;
+  auto visit = [&](uint32_t x) {
+    if (open && x == last + 1) {
+      last = x;
+      return;
+    }
+    if (open)
+      emit(start, last);
+    open = true;
+    start = last = x;
+  };
+  if (b.type == roaring_bitmap::array_block) {
+    for (auto x : b.values)
+      visit(x);
+  } else {
+    for (size_t i = 0; i < bitmap_words; ++i)
+      for (auto w = b.bits[i]; w != 0; w &= w - 1)
+        visit(static_cast<uint32_t>(i * 64 + lowest_bit(w)));
+  }
+  if (open)
+    emit(start, last);
+  b.values.swap(rs);
+  b.bits.clear();
+  b.bits.shrink_to_fit();
+  b.type = roaring_bitmap::run_block;
+}
+
+bool block_contains(const block& b, uint16_t low) {
+  switch (b.type) {
+    case roaring_bitmap::array_block:
+      return std::binary_search(b.values.begin(), b.values.end(), low);
+    case roaring_bitmap::bitmap_block:
+      return test_bit(b.bits.data(), low);
+    default:
+      return find_run(b, low) < runs(b);
+  }
+}
+
+/// Adds all values of `y` to `x` and stores the values which have been
+/// missing in `x` in `delta`
+/// @returns the number of added values
+size_t merge_block(block& x, const block& y, block& delta) {
+  materialize(x);
+  delta.key = x.key;
+  if (x.type == roaring_bitmap::array_block
+      && y.type == roaring_bitmap::array_block
+      && x.card + y.card <= max_array) {
+    std::vector<uint16_t> xs;
+    xs.reserve(x.card + y.card);
+    auto i = x.values.begin();
+    for (auto v : y.values) {
+      while (i != x.values.end() && *i < v)
+        xs.push_back(*i++);
+      if (i != x.values.end() && *i == v) {
+        xs.push_back(*i++);
+        continue;
+      }
+      xs.push_back(v);
+      delta.values.push_back(v);
+    }
+    xs.insert(xs.end(), i, x.values.end());
+    x.values.swap(xs);
+    delta.type = roaring_bitmap::array_block;
+    delta.card = static_cast<uint32_t>(delta.values.size());
+    x.card += delta.card;
+    return delta.card;
+  }
+  to_bitmap(x);
+  uint64_t tmp[bitmap_words];
+  const uint64_t* src = y.bits.data();
+  if (y.type != roaring_bitmap::bitmap_block) {
+    std::fill(tmp, tmp + bitmap_words, uint64_t{0});
+    fill_bits(y, tmp);
+    src = tmp;
+  }
+  delta.type = roaring_bitmap::bitmap_block;
+  delta.bits.resize(bitmap_words);
+  auto& kernels = bitmap_kernels::instance();
+  auto added = kernels.merge(x.bits.data(), src, delta.bits.data(),
+                             bitmap_words);
+  delta.card = static_cast<uint32_t>(added);
+  x.card += delta.card;
+  settle(x);
+  settle(delta);
+  return added;
+}
+
+/// Sorts and merges the runs of `b`, drops runs exceeding the block
+void repair_runs(block& b) {
+  std::vector<std::pair<uint32_t, uint32_t>> xs;
+  for (size_t i = 0; i < runs(b); ++i)
+    xs.emplace_back(run_start(b, i), std::min(run_last(b, i), block_size - 1));
+  std::sort(xs.begin(), xs.end());
+  b.values.clear();
+  b.card = 0;
+  for (auto& x : xs) {
+    auto n = runs(b);
+    if (n > 0 && x.first <= run_last(b, n - 1) + 1) {
+      auto last = std::max(run_last(b, n - 1), x.second);
+      b.card += last - run_last(b, n - 1);
+      b.values[2 * n - 1] = static_cast<uint16_t>(last - run_start(b, n - 1));
+      continue;
+    }
+    b.values.push_back(static_cast<uint16_t>(x.first));
+    b.values.push_back(static_cast<uint16_t>(x.second - x.first));
+    b.card += x.second - x.first + 1;
+  }
+}
+
+} // namespace <anonymous>
+
+bool roaring_bitmap::add(uint64_t x) {
+  auto key = key_of(x);
+  auto low = low_of(x);
+  auto i = std::lower_bound(blocks_.begin(), blocks_.end(), key,
+                            [](const block& b, uint64_t k) {
+                              return b.key < k;
+                            });
+  if (i == blocks_.end() || i->key != key) {
+    i = blocks_.insert(i, block{});
+    i->key = key;
+  }
+  auto& b = *i;
+  materialize(b);
+  if (b.type == bitmap_block) {
+    if (test_bit(b.bits.data(), low))
+      return false;
+    set_bit(b.bits.data(), low);
+  } else {
+    auto j = std::lower_bound(b.values.begin(), b.values.end(), low);
+    if (j != b.values.end() && *j == low)
+      return false;
+    b.values.insert(j, low);
+  }
+  ++b.card;
+  ++size_;
+  if (b.card > max_array)
+    to_bitmap(b);
+  return true;
+}
+
+bool roaring_bitmap::contains(uint64_t x) const {
+  auto key = key_of(x);
+  auto i = std::lower_bound(blocks_.begin(), blocks_.end(), key,
+                            [](const block& b, uint64_t k) {
+                              return b.key < k;
+                            });
+  return i != blocks_.end() && i->key == key && block_contains(*i, low_of(x));
+}
+
+roaring_bitmap::const_iterator roaring_bitmap::find(uint64_t x) const {
+  auto key = key_of(x);
+  auto low = low_of(x);
+  auto i = std::lower_bound(blocks_.begin(), blocks_.end(), key,
+                            [](const block& b, uint64_t k) {
+                              return b.key < k;
+                            });
+  if (i == blocks_.end() || i->key != key || !block_contains(*i, low))
+    return end();
+  const_iterator result;
+  result.parent_ = this;
+  result.block_ = static_cast<size_t>(i - blocks_.begin());
+  result.value_ = x;
+  switch (i->type) {
+    case array_block:
+      result.pos_ = static_cast<uint32_t>(
+        std::lower_bound(i->values.begin(), i->values.end(), low)
+        - i->values.begin());
+      break;
+    case bitmap_block:
+      result.pos_ = low;
+      break;
+    default:
+      result.pos_ = static_cast<uint32_t>(find_run(*i, low));
+      result.low_ = low;
+  }
+  return result;
+}
+
+void roaring_bitmap::merge(const roaring_bitmap& other,
+                           roaring_bitmap& delta) {
+  delta.clear();
+  if (other.empty())
+    return;
+  std::vector<block> result;
+  result.reserve(blocks_.size() + other.blocks_.size());
+  auto i = blocks_.begin();
+  for (auto& y : other.blocks_) {
+    while (i != blocks_.end() && i->key < y.key)
+      result.push_back(std::move(*i++));
+    if (i == blocks_.end() || y.key < i->key) {
+      result.push_back(y);
+      delta.blocks_.push_back(y);
+      size_ += y.card;
+      delta.size_ += y.card;
+      continue;
+    }
+    block d;
+    auto added = merge_block(*i, y, d);
+    result.push_back(std::move(*i++));
+    if (added > 0) {
+      size_ += added;
+      delta.size_ += added;
+      delta.blocks_.push_back(std::move(d));
+    }
+  }
+  std::move(i, blocks_.end(), std::back_inserter(result));
+  blocks_.swap(result);
+}
+
+void roaring_bitmap::optimize() {
+  for (auto& b : blocks_)
+    optimize_block(b);
+}
+
+std::vector<roaring_bitmap::block> roaring_bitmap::optimized() const {
+  auto xs = blocks_;
+  for (auto& b : xs)
+    optimize_block(b);
+  return xs;
+}
+
+void roaring_bitmap::clear() {
+  blocks_.clear();
+  size_ = 0;
+}
+
+roaring_bitmap::const_iterator roaring_bitmap::begin() const {
+  const_iterator result;
+  result.parent_ = this;
+  enter(result);
+  return result;
+}
+
+roaring_bitmap::const_iterator roaring_bitmap::end() const {
+  const_iterator result;
+  result.parent_ = this;
+  result.block_ = blocks_.size();
+  return result;
+}
+
+void roaring_bitmap::enter(const_iterator& it) const {
+  it.pos_ = 0;
+  it.low_ = 0;
+  if (it.block_ < blocks_.size() && blocks_[it.block_].type == run_block)
+    it.low_ = run_start(blocks_[it.block_], 0);
+  seek(it);
+}
+
+void roaring_bitmap::advance(const_iterator& it) const {
+  auto& b = blocks_[it.block_];
+  switch (b.type) {
+    case array_block:
+      ++it.pos_;
+      break;
+    case bitmap_block:
+      ++it.pos_;
+      break;
+    default:
+      if (it.low_ < run_last(b, it.pos_)) {
+        ++it.low_;
+      } else if (++it.pos_ < runs(b)) {
+        it.low_ = run_start(b, it.pos_);
+      }
+  }
+  seek(it);
+}
+
+void roaring_bitmap::seek(const_iterator& it) const {
+  while (it.block_ < blocks_.size()) {
+    auto& b = blocks_[it.block_];
+    auto base = b.key << 16;
+    switch (b.type) {
+      case array_block:
+        if (it.pos_ < b.values.size()) {
+          it.value_ = base | b.values[it.pos_];
+          return;
+        }
+        break;
+      case bitmap_block:
+        for (auto i = it.pos_ / 64; i < bitmap_words; ++i) {
+          auto w = b.bits[i];
+          if (i == it.pos_ / 64)
+            w &= ~uint64_t{0} << (it.pos_ % 64);
+          if (w != 0) {
+            it.pos_ = static_cast<uint32_t>(i * 64 + lowest_bit(w));
+            it.value_ = base | it.pos_;
+            return;
+          }
+        }
+        break;
+      default:
+        if (it.pos_ < runs(b)) {
+          it.value_ = base | it.low_;
+          return;
+        }
+    }
+    ++it.block_;
+    it.pos_ = 0;
+    it.low_ = 0;
+    if (it.block_ < blocks_.size() && blocks_[it.block_].type == run_block)
+      it.low_ = run_start(blocks_[it.block_], 0);
+  }
+  // Normalize to `end()`
+  it.pos_ = 0;
+  it.low_ = 0;
+  it.value_ = 0;
+}
+
+void roaring_bitmap::repair() {
+  size_ = 0;
+  for (auto& b : blocks_) {
+    switch (b.type) {
+      case array_block:
+        std::sort(b.values.begin(), b.values.end());
+        b.values.erase(std::unique(b.values.begin(), b.values.end()),
+                       b.values.end());
+        b.bits.clear();
+        b.card = static_cast<uint32_t>(b.values.size());
+        break;
+      case bitmap_block:
+        b.bits.resize(bitmap_words);
+        b.values.clear();
+        b.card = static_cast<uint32_t>(
+          bitmap_kernels::instance().count(b.bits.data(), bitmap_words));
+        break;
+      case run_block:
+        b.values.resize(runs(b) * 2);
+        b.bits.clear();
+        repair_runs(b);
+        break;
+      default:
+        b.card = 0;
+    }
+    if (b.type != run_block && b.card > 0)
+      settle(b);
+  }
+  auto is_empty = [](const block& b) { return b.card == 0; };
+  blocks_.erase(std::remove_if(blocks_.begin(), blocks_.end(), is_empty),
+                blocks_.end());
+  std::stable_sort(blocks_.begin(), blocks_.end(),
+                   [](const block& x, const block& y) {
+                     return x.key < y.key;
+                   });
+  // Fold blocks with duplicate keys
+  std::vector<block> xs;
+  for (auto& b : blocks_) {
+    if (!xs.empty() && xs.back().key == b.key) {
+      block delta;
+      merge_block(xs.back(), b, delta);
+    } else {
+      xs.push_back(std::move(b));
+    }
+  }
+  blocks_.swap(xs);
+  for (auto& b : blocks_)
+    size_ += b.card;
+}
+
+namespace caf {
+namespace crdt {
+namespace detail {
+
+bool operator==(const roaring_bitmap& lhs, const roaring_bitmap& rhs) {
+  // Equal sets may use different containers, compare the values
+  return lhs.size() == rhs.size()
+         && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+bool operator<(const roaring_bitmap& lhs, const roaring_bitmap& rhs) {
+  return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(),
+                                      rhs.end());
+}
+
+} // namespace detail
+} // namespace crdt
+} // namespace caf
@@ -0,0 +1,152 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/crdt/detail/slot_registry.hpp"
+
+#include <algorithm>
+
+using namespace caf;
+using namespace caf::crdt::detail;
+
+slot_registry& slot_registry::instance() {
+  static slot_registry registry;
+  return registry;
+}
+
+slot_registry::slot_id slot_registry::intern(const key_type& key) {
+  // Ids never change once interned, the cache stays valid forever
+  thread_local std::unordered_map<key_type, slot_id, key_hash> cache;
+  auto iter = cache.find(key);
+  if (iter != cache.end())
+    return iter->second;
+  slot_id id;
+  { // lifetime scope of guard
+    std::lock_guard<std::mutex> guard{mtx_};
+    id = unsafe_intern(key);
+  }
+  cache.emplace(key, id);
+  return id;
+}
+
+bool slot_registry::find(const key_type& key, slot_id& result) const {
+  std::lock_guard<std::mutex> guard{mtx_};
+  auto iter = ids_.find(key);
+  if (iter == ids_.end())
+    return false;
+  result = iter->second;
+  return true;
+}
+
+uint64_t slot_registry::next_counter(slot_id slot, const std::string& scope) {
+  return add_counter(slot, scope, 1);
+}
+
+uint64_t slot_registry::add_counter(slot_id slot, const std::string& scope,
+                                    uint64_t n) {
+  return counter(slot, scope).fetch_add(n, std::memory_order_relaxed) + n;
+}
+
+slot_registry::key_type slot_registry::key(slot_id id) const {
+  std::lock_guard<std::mutex> guard{mtx_};
+  return keys_[id];
+}
+
+void slot_registry::keys(const slot_id* first, size_t n,
+                         std::vector<key_type>& out) const {
+  out.reserve(out.size() + n);
+  std::lock_guard<std::mutex> guard{mtx_};
+  for (size_t i = 0; i < n; ++i)
+    out.emplace_back(keys_[first[i]]);
+}
+
+void slot_registry::intern(const key_type* first, size_t n,
+                           std::vector<slot_id>& out) {
+  out.reserve(out.size() + n);
+  std::lock_guard<std::mutex> guard{mtx_};
+  for (size_t i = 0; i < n; ++i)
+    out.emplace_back(unsafe_intern(first[i]));
+}
+
+void slot_registry::retire(const node_id& node) {
+  std::lock_guard<std::mutex> guard{mtx_};
+  if (!retired_nodes_.emplace(node).second)
+    return;
+  std::vector<slot_id> xs;
+  if (retired_slots_)
+    xs = *retired_slots_;
+  for (slot_id id = 0; id < keys_.size(); ++id)
+    if (keys_[id].first == node)
+      xs.emplace_back(id);
+  std::sort(xs.begin(), xs.end());
+  retired_slots_ = std::make_shared<const std::vector<slot_id>>(std::move(xs));
+  generation_.fetch_add(1, std::memory_order_release);
+}
+
+bool slot_registry::retired(const node_id& node) const {
+  std::lock_guard<std::mutex> guard{mtx_};
+  return retired_nodes_.count(node) > 0;
+}
+
+std::shared_ptr<const std::vector<slot_registry::slot_id>>
+slot_registry::retired_slots() const {
+  std::lock_guard<std::mutex> guard{mtx_};
+  return retired_slots_;
+}
+
+std::atomic<uint64_t>& slot_registry::counter(slot_id slot,
+                                              const std::string& scope) {
+  // Elements of unordered maps keep their address, counters are never erased
+  using cache_key = std::pair<slot_id, std::string>;
+  struct cache_hash {
+    size_t operator()(const cache_key& x) const {
+      auto h = std::hash<std::string>{}(x.second);
+      return h ^ (x.first + 0x9e3779b9 + (h << 6) + (h >> 2));
+    }
+  };
+  thread_local std::unordered_map<cache_key, std::atomic<uint64_t>*,
+                                  cache_hash> cache;
+  cache_key key{slot, scope};
+  auto iter = cache.find(key);
+  if (iter != cache.end())
+    return *iter->second;
+  std::atomic<uint64_t>* result;
+  { // lifetime scope of guard
+    std::lock_guard<std::mutex> guard{mtx_};
+    result = &counters_[slot][scope];
+  }
+  cache.emplace(std::move(key), result);
+  return *result;
+}
+
+slot_registry::slot_id slot_registry::unsafe_intern(const key_type& key) {
+  auto iter = ids_.find(key);
+  if (iter != ids_.end())
+    return iter->second;
+  auto id = static_cast<slot_id>(keys_.size());
+  keys_.emplace_back(key);
+  ids_.emplace(key, id);
+  // Slots of retired nodes may still arrive with stale messages
+  if (!retired_nodes_.empty() && retired_nodes_.count(key.first) > 0) {
+    auto xs = *retired_slots_;
+    xs.emplace_back(id); // New ids are the largest, `xs` remains sorted
+    retired_slots_ = std::make_shared<const std::vector<slot_id>>(std::move(xs));
+    generation_.fetch_add(1, std::memory_order_release);
+  }
+  return id;
+}
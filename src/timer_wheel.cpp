@@ -0,0 +1,159 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+
+
+#include "caf/crdt/detail/timer_wheel.hpp"
+
+#include "caf/crdt/atom_types.hpp"
+
+using namespace caf;
+using namespace caf::crdt;
+using namespace caf::crdt::detail;
+
+namespace {
+
+/// Bits of a slot index
+constexpr size_t slot_bits = 6;
+
+/// @returns the first tick of level `l`
+inline size_t shift_of(size_t l) {
+  return slot_bits * l;
+}
+
+/// @returns `x` without the ticks below level `l`, i.e., the first tick of
+///          the slot range at level `l - 1` containing `x`
+inline uint64_t prefix(uint64_t x, size_t l) {
+  auto shift = shift_of(l);
+  return shift < 64 ? x >> shift : 0;
+}
+
+/// @returns the milliseconds since tick 0 of `st`
+uint64_t elapsed_ms(const notify_wheel_state& st) {
+  using namespace std::chrono;
+  auto d = steady_clock::now() - st.start;
+  return static_cast<uint64_t>(duration_cast<milliseconds>(d).count());
+}
+
+/// Schedules a tick for the next expiry unless an earlier one is pending
+void wake_up(stateful_actor<notify_wheel_state>* self) {
+  auto& st = self->state;
+  auto delay = st.wheel.next_expiry();
+  if (delay == timer_wheel::never)
+    return;
+  auto at = st.wheel.now() + delay;
+  if (at >= st.wake)
+    return;
+  st.wake = at;
+  self->delayed_send(self, std::chrono::milliseconds(delay),
+                     wheel_tick_atom::value, at);
+}
+
+} // namespace <anonymous>
+
+constexpr size_t timer_wheel::slots;
+constexpr size_t timer_wheel::levels;
+constexpr uint64_t timer_wheel::never;
+
+timer_wheel::timer_wheel() : now_{0}, size_{0} {
+  occupied_.fill(0);
+}
+
+void timer_wheel::schedule(uint64_t delay, actor target) {
+  delay = std::max(delay, uint64_t{1});
+  auto deadline = delay < never - now_ ? now_ + delay : never;
+  insert(entry{deadline, std::move(target)});
+  ++size_;
+}
+
+uint64_t timer_wheel::next_expiry() const {
+  if (size_ == 0)
+    return never;
+  for (size_t l = 0; l < levels; ++l) {
+    // Slots before the current one have been cascaded or expired
+    auto digit = prefix(now_, l) % slots;
+    auto mask = digit + 1 < slots ? occupied_[l] & (~uint64_t{0} << (digit + 1))
+                                  : uint64_t{0};
+    if (mask == 0)
+      continue;
+    uint64_t slot = 0;
+    while ((mask & (uint64_t{1} << slot)) == 0)
+      ++slot;
+    auto first = l + 1 < levels ? prefix(now_, l + 1) << shift_of(l + 1) : 0;
+    return first + (slot << shift_of(l)) - now_;
+  }
+  return never;
+}
+
+void timer_wheel::insert(entry x) {
+  for (size_t l = 0; l < levels; ++l) {
+    if (prefix(x.deadline, l + 1) != prefix(now_, l + 1))
+      continue;
+    auto slot = prefix(x.deadline, l) % slots;
+    wheel_[l][slot].emplace_back(std::move(x));
+    occupied_[l] |= uint64_t{1} << slot;
+    return;
+  }
+}
+
+void timer_wheel::cascade() {
+  // Find the highest level whose current slot starts at this tick
+  size_t top = 0;
+  while (top + 1 < levels
+         && (now_ & ((uint64_t{1} << shift_of(top + 1)) - 1)) == 0)
+    ++top;
+  // Higher levels first, their timers may land in lower slots starting now
+  for (auto l = top; l > 0; --l) {
+    auto slot = prefix(now_, l) % slots;
+    if ((occupied_[l] & (uint64_t{1} << slot)) == 0)
+      continue;
+    occupied_[l] &= ~(uint64_t{1} << slot);
+    auto xs = std::move(wheel_[l][slot]);
+    wheel_[l][slot].clear();
+    for (auto& x : xs)
+      insert(std::move(x));
+  }
+}
+
+const char* notify_wheel_state::name = "notify_wheel";
+
+behavior caf::crdt::detail::notify_wheel(
+    stateful_actor<notify_wheel_state>* self) {
+  self->state.start = std::chrono::steady_clock::now();
+  auto expire = [=] {
+    self->state.wheel.advance(elapsed_ms(self->state), [=](actor& x) {
+      self->send(x, notify_atom::value);
+    });
+  };
+  return {
+    [=](notify_atom, size_t delay_ms) {
+      expire();
+      auto sender = actor_cast<actor>(self->current_sender());
+      if (sender)
+        self->state.wheel.schedule(delay_ms, std::move(sender));
+      wake_up(self);
+    },
+    [=](wheel_tick_atom, uint64_t at) {
+      if (at == self->state.wake)
+        self->state.wake = timer_wheel::never;
+      expire();
+      wake_up(self);
+    }
+  };
+}
@@ -0,0 +1,46 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+
+#include "caf/crdt/detail/uri_registry.hpp"
+
+using namespace caf;
+using namespace caf::crdt;
+using namespace caf::crdt::detail;
+
+uri_registry& uri_registry::instance() {
+  static uri_registry registry;
+  return registry;
+}
+
+uri_registry::uri_id uri_registry::intern(const uri& x) {
+  std::lock_guard<std::mutex> guard{mtx_};
+  auto iter = ids_.find(x);
+  if (iter != ids_.end())
+    return iter->second;
+  auto id = static_cast<uri_id>(uris_.size());
+  uris_.emplace_back(x);
+  ids_.emplace(x, id);
+  return id;
+}
+
+uri uri_registry::get(uri_id id) const {
+  std::lock_guard<std::mutex> guard{mtx_};
+  return uris_[id];
+}
@@ -19,88 +19,287 @@
 
 #include "caf/crdt/vector_clock.hpp"
 
+#include "caf/crdt/detail/digest.hpp"
+#include "caf/crdt/detail/clock_kernels.hpp"
+
+#include <algorithm>
+
 using namespace caf;
 using namespace caf::crdt;
 
+namespace {
+
+using registry = detail::slot_registry;
+
+registry::key_type key_of(const actor& x) {
+  if (!x)
+    return {node_id{}, actor_id{0}};
+  return {x.node(), x.id()};
+}
+
+vector_clock_result to_result(bool g, bool s) {
+  if (g && s) return concurrent;
+  if (g)      return greater;
+  if (s)      return smaller;
+  return equal;
+}
+
+} // namespace <anonymous>
+
 vector_clock vector_clock::increment(const actor& slot, bool delta) {
-  map_[slot]++;
+  auto id = registry::instance().intern(key_of(slot));
+  auto pos = advance(id, value_of(id) + 1);
   if (delta) // Return only delta
-    return {slot, map_[slot]};
+    return {id, values_[pos]};
+  return *this; // Return a full copy
+}
+
+vector_clock vector_clock::increment(const node_id& slot,
+                                     const std::string& scope, bool delta) {
+  auto& reg = registry::instance();
+  auto id = reg.intern(slot);
+  // The counter is shared by all actors of this node, hence the new value
+  // is greater than any value this node has ever issued for `scope`.
+  auto pos = advance(id, reg.next_counter(id, scope));
+  if (delta) // Return only delta
+    return {id, values_[pos]};
   return *this; // Return a full copy
 }
 
 size_t vector_clock::get(const actor& key) const {
-  auto iter = map_.find(key);
-  return iter == map_.end() ? 0 : iter->second;
+  slot_id id;
+  if (!registry::instance().find(key_of(key), id))
+    return 0;
+  return value_of(id);
+}
+
+size_t vector_clock::get(const node_id& key) const {
+  slot_id id;
+  if (!registry::instance().find({key, actor_id{0}}, id))
+    return 0;
+  return value_of(id);
 }
 
 vector_clock_result vector_clock::compare(const vector_clock& other) const {
-  bool e = true; // equal
-  bool g = true; // greater
-  bool s = true; // smaller
-  for (auto& entry : map_) {
-    auto key = entry.first;
-    auto value = entry.second;
-    if (other.count(key)) {
-      if (value < other.get(key)) {
-         e = false;
-         g = false;
-      }
-      if (value > other.get(key)) {
-         e = false;
-         s = false;
-      }
-    } else if (value != 0) {
-      e = false;
-      s = false;
-    }
+  bool g = false; // `this` has a slot greater than `other`
+  bool s = false; // `this` has a slot smaller than `other`
+  auto n = slots_.size();
+  auto m = other.slots_.size();
+  if (slots_ == other.slots_) {
+    auto& kernels = detail::clock_kernels::instance();
+    kernels.dominance(values_.data(), other.values_.data(), n, g, s);
+    return to_result(g, s);
   }
-  for (auto& entry : other.map_) {
-    if (!map_.count(entry.first) && entry.second != 0) {
-      e = false;
-      g = false;
+  size_t i = 0;
+  size_t j = 0;
+  while (i < n && j < m && !(g && s)) {
+    if (slots_[i] < other.slots_[j]) {
+      g |= values_[i++] != 0;
+    } else if (other.slots_[j] < slots_[i]) {
+      s |= other.values_[j++] != 0;
+    } else {
+      g |= values_[i] > other.values_[j];
+      s |= values_[i] < other.values_[j];
+      ++i;
+      ++j;
     }
   }
-  if (e) return equal;
-  if (g && !s) return greater;
-  if (!g && s) return smaller;
-  return concurrent;
+  for (; i < n && !g; ++i)
+    g = values_[i] != 0;
+  for (; j < m && !s; ++j)
+    s = other.values_[j] != 0;
+  return to_result(g, s);
 }
 
 vector_clock vector_clock::merge(const vector_clock& other) {
-  map_type delta;
-  // Copy entries into delta which are not in `this`
-  auto not_in_other = [&](const value_type& e) {
-    return other.map_.count(e.first) == 0;
-  };
-  std::copy_if(map_.begin(), map_.end(),
-               std::inserter(delta, delta.end()), not_in_other);
-  // Copy entries which are not in `this` or are less than in `other`
-  auto not_in_this_or_max = [&](const value_type& e) {
-    auto& key = e.first;
-    auto this_iter = map_.find(key);
-    if (this_iter == map_.end())
-      return true;
-    auto other_iter = other.map_.find(key);
-    return (this_iter->second < other_iter->second);
+  return merge_impl(other, true);
+}
+
+vector_clock vector_clock::merge_impl(const vector_clock& other,
+                                      bool drop_retired) {
+  auto& reg = registry::instance();
+  if (drop_retired && generation_ != reg.generation())
+    compact();
+  // Once compacted, `this` holds no retired slots. Hence, `other` holds none
+  // either if the slots are equal and only missing slots need to be checked.
+  if (slots_ == other.slots_)
+    return merge_aligned(other);
+  std::shared_ptr<const std::vector<slot_id>> retired;
+  if (drop_retired && generation_ != 0)
+    retired = reg.retired_slots();
+  auto is_retired = [&](slot_id x) {
+    return retired && std::binary_search(retired->begin(), retired->end(), x);
   };
-  std::copy_if(other.map_.begin(), other.map_.end(),
-               std::inserter(delta, delta.end()), not_in_this_or_max);
-  // Apply delta to `this`
-  for (auto& e : delta) {
-    auto key = e.first;
-    map_[key] = std::max(map_[key], e.second);
+  auto n = slots_.size();
+  auto m = other.slots_.size();
+  // Count slots which differ and slots which are missing in `this`
+  size_t differ = 0;
+  size_t missing = 0;
+  for (size_t i = 0, j = 0; i < n || j < m;) {
+    if (j == m || (i < n && slots_[i] < other.slots_[j])) {
+      ++differ;
+      ++i;
+    } else if (i == n || other.slots_[j] < slots_[i]) {
+      if (is_retired(other.slots_[j++]))
+        continue;
+      ++differ;
+      ++missing;
+    } else {
+      differ += values_[i] != other.values_[j] ? 1 : 0;
+      ++i;
+      ++j;
+    }
+  }
+  vector_clock delta;
+  if (differ == 0)
+    return delta;
+  delta.slots_.resize(differ);
+  delta.values_.resize(differ);
+  // Merge back to front, this allows to grow `this` in place
+  slots_.resize(n + missing);
+  values_.resize(n + missing);
+  auto i = n;
+  auto j = m;
+  auto k = n + missing;
+  auto d = differ;
+  while (d > 0) {
+    if (j == 0 || (i > 0 && slots_[i - 1] > other.slots_[j - 1])) {
+      --i;
+      --k;
+      slots_[k] = slots_[i];
+      values_[k] = values_[i];
+    } else if (i == 0 || other.slots_[j - 1] > slots_[i - 1]) {
+      if (is_retired(other.slots_[--j]))
+        continue;
+      --k;
+      slots_[k] = other.slots_[j];
+      values_[k] = other.values_[j];
+    } else {
+      --i;
+      --j;
+      --k;
+      auto x = values_[i];
+      auto y = other.values_[j];
+      slots_[k] = slots_[i];
+      values_[k] = std::max(x, y);
+      if (x == y)
+        continue;
+    }
+    --d;
+    delta.slots_[d] = slots_[k];
+    delta.values_[d] = values_[k];
+  }
+  return delta;
+}
+
+vector_clock vector_clock::merge_aligned(const vector_clock& other) {
+  auto& kernels = detail::clock_kernels::instance();
+  auto n = values_.size();
+  vector_clock delta;
+  auto differ = kernels.count_differ(values_.data(), other.values_.data(), n);
+  if (differ == 0)
+    return delta;
+  delta.slots_.reserve(differ);
+  delta.values_.reserve(differ);
+  for (size_t i = 0; i < n; ++i) {
+    if (values_[i] != other.values_[i]) {
+      delta.slots_.push_back(slots_[i]);
+      delta.values_.push_back(std::max(values_[i], other.values_[i]));
+    }
   }
-  return {std::move(delta)};
+  kernels.join(values_.data(), other.values_.data(), n);
+  return delta;
 }
 
 size_t vector_clock::count() const {
-  size_t value = 0;
-  for (auto& e : map_)
-    value += map_.count(e.first);
-  return value;
+  return slots_.size();
 }
 
-size_t vector_clock::count(const actor& slot) const {
-  return map_.count(slot);
+bool vector_clock::compact() {
+  auto& reg = registry::instance();
+  generation_ = reg.generation();
+  auto retired = reg.retired_slots();
+  if (!retired || slots_.empty())
+    return false;
+  // Both arrays are sorted, drop retired slots in one merge-join pass
+  size_t k = 0;
+  auto r = retired->begin();
+  for (size_t i = 0; i < slots_.size(); ++i) {
+    r = std::lower_bound(r, retired->end(), slots_[i]);
+    if (r != retired->end() && *r == slots_[i])
+      continue;
+    slots_[k] = slots_[i];
+    values_[k] = values_[i];
+    ++k;
+  }
+  if (k == slots_.size())
+    return false;
+  slots_.resize(k);
+  values_.resize(k);
+  return true;
+}
+
+uint64_t vector_clock::fingerprint() const {
+  uint64_t result = 0;
+  for (auto& x : entries())
+    detail::fingerprint_add(result, detail::fingerprint(x));
+  return result;
+}
+
+std::vector<vector_clock::slot_entry> vector_clock::entries() const {
+  std::vector<registry::key_type> keys;
+  registry::instance().keys(slots_.data(), slots_.size(), keys);
+  std::vector<slot_entry> result;
+  result.reserve(keys.size());
+  for (size_t i = 0; i < keys.size(); ++i)
+    result.push_back(slot_entry{std::move(keys[i].first), keys[i].second,
+                                values_[i]});
+  return result;
+}
+
+void vector_clock::assign(const std::vector<slot_entry>& xs) {
+  std::vector<registry::key_type> keys;
+  keys.reserve(xs.size());
+  for (auto& x : xs)
+    keys.emplace_back(x.node, x.aid);
+  std::vector<slot_id> ids;
+  registry::instance().intern(keys.data(), keys.size(), ids);
+  std::vector<size_t> order(xs.size());
+  for (size_t i = 0; i < order.size(); ++i)
+    order[i] = i;
+  std::sort(order.begin(), order.end(),
+            [&](size_t lhs, size_t rhs) { return ids[lhs] < ids[rhs]; });
+  slots_.clear();
+  values_.clear();
+  slots_.reserve(xs.size());
+  values_.reserve(xs.size());
+  for (auto idx : order) {
+    if (!slots_.empty() && slots_.back() == ids[idx]) {
+      values_.back() = std::max(values_.back(), xs[idx].value);
+      continue;
+    }
+    slots_.push_back(ids[idx]);
+    values_.push_back(xs[idx].value);
+  }
+}
+
+size_t vector_clock::lower_bound(slot_id slot) const {
+  auto iter = std::lower_bound(slots_.begin(), slots_.end(), slot);
+  return static_cast<size_t>(std::distance(slots_.begin(), iter));
+}
+
+uint64_t vector_clock::value_of(slot_id slot) const {
+  auto pos = lower_bound(slot);
+  return pos < slots_.size() && slots_[pos] == slot ? values_[pos] : 0;
+}
+
+size_t vector_clock::advance(slot_id slot, uint64_t value) {
+  auto pos = lower_bound(slot);
+  if (pos == slots_.size() || slots_[pos] != slot) {
+    slots_.insert(slots_.begin() + pos, slot);
+    values_.insert(values_.begin() + pos, value);
+  } else {
+    values_[pos] = std::max(values_[pos], value);
+  }
+  return pos;
 }
@@ -29,7 +29,14 @@ using namespace caf::crdt::types;
 
 namespace {
 
-class config : public crdt_config {};
+class config : public crdt_config {
+public:
+  config() {
+    add_crdt<gcounter<int, node_slots>>("gcounter<int>");
+    // Flush each buffered delta, the metrics then count the publishes
+    set_flush_max_deltas(1);
+  }
+};
 
 struct fixture {
   fixture() : system{cfg} {
@@ -62,4 +69,119 @@ CAF_TEST(merge) {
   CAF_CHECK(delta.count() == 1);
 }
 
+CAF_TEST(many_contributors) {
+  auto dummy_actor = [](event_based_actor*) {};
+  gcounter<int> total{system.spawn(dummy_actor)};
+  for (int i = 1; i <= 64; ++i) {
+    gcounter<int> x{system.spawn(dummy_actor)};
+    x.increment_by(i);
+    auto delta = total.merge(x);
+    CAF_CHECK(delta.count() == i);
+    x.increment();
+    total.merge(x);
+  }
+  CAF_CHECK(total.count() == 64 * 65 / 2 + 64);
+  std::vector<char> buf;
+  binary_serializer sink{system, buf};
+  sink & total;
+  gcounter<int> copy;
+  binary_deserializer source{system, buf};
+  source & copy;
+  CAF_CHECK(copy.count() == total.count());
+  CAF_CHECK(total.merge(copy).empty());
+}
+
+CAF_TEST(node_slots) {
+  auto dummy_actor = [](event_based_actor*) {};
+  gcounter<int, node_slots> total{system.spawn(dummy_actor)};
+  int expected = 0;
+  for (int i = 1; i <= 16; ++i) {
+    gcounter<int, node_slots> x{system.spawn(dummy_actor),
+                                "gcounter<int>://node_slots"};
+    x.increment_by(i);
+    expected += i;
+    CAF_CHECK(x.count() == expected);
+  }
+  // All increments aggregate into the slot of this node, hence the state of
+  // each incrementer covers all previous increments and has a single slot.
+  gcounter<int, node_slots> last{system.spawn(dummy_actor),
+                                 "gcounter<int>://node_slots"};
+  last.increment();
+  ++expected;
+  CAF_CHECK(total.merge(last).count() == expected);
+  CAF_CHECK(total.count() == expected);
+  std::vector<char> buf;
+  binary_serializer sink{system, buf};
+  sink & total;
+  std::vector<gcounter<int, node_slots>::slot_entry> xs;
+  binary_deserializer source{system, buf};
+  source & xs;
+  CAF_CHECK(xs.size() == 1);
+  // Unnamed counters have no replica and keep one slot per actor
+  gcounter<int, node_slots> lhs{system.spawn(dummy_actor)};
+  gcounter<int, node_slots> rhs{system.spawn(dummy_actor)};
+  lhs.increment();
+  rhs.increment();
+  lhs.merge(rhs);
+  CAF_CHECK(lhs.count() == 2);
+}
+
+CAF_TEST(equal_roots) {
+  // Counters of two other nodes, both nodes retire and leave base values
+  config lhs_cfg;
+  actor_system lhs_sys{lhs_cfg};
+  config rhs_cfg;
+  actor_system rhs_sys{rhs_cfg};
+  auto dummy_actor = [](event_based_actor*) {};
+  gcounter<int> a{lhs_sys.spawn(dummy_actor)};
+  gcounter<int> b{rhs_sys.spawn(dummy_actor)};
+  gcounter<int> c{system.spawn(dummy_actor)};
+  a.increment();
+  b.increment_by(2);
+  c.increment_by(3);
+  auto& reg = crdt::detail::slot_registry::instance();
+  reg.retire(lhs_sys.node());
+  reg.retire(rhs_sys.node());
+  a.compact();
+  b.compact();
+  // Equal states have equal roots regardless of the order of merges
+  gcounter<int> lhs;
+  gcounter<int> rhs;
+  for (auto x : {&a, &b, &c})
+    lhs.merge(*x);
+  for (auto x : {&c, &b, &a})
+    rhs.merge(*x);
+  CAF_CHECK(lhs.count() == 6);
+  CAF_CHECK(rhs.count() == 6);
+  CAF_CHECK(crdt::detail::digest_root(lhs) == crdt::detail::digest_root(rhs));
+  c.increment();
+  rhs.merge(c);
+  CAF_CHECK(crdt::detail::digest_root(lhs) != crdt::detail::digest_root(rhs));
+}
+
+CAF_TEST(batch_scope) {
+  scoped_actor self{system};
+  using counter = gcounter<int, node_slots>;
+  auto& metrics = system.replicator().metrics();
+  auto published = metrics.deltas();
+  counter x{actor_cast<actor>(self), "gcounter<int>://batch"};
+  {
+    auto scope = x.batch();
+    for (int i = 0; i < 100; ++i)
+      x.increment();
+    auto nested = x.batch();
+    x.increment();
+  } // Publishes a single delta
+  CAF_CHECK(x.count() == 101);
+  auto repl = actor_cast<actor>(system.replicator().actor_handle());
+  int count = 0;
+  self->request(repl, std::chrono::seconds(1), read_local_atom::value,
+                uri{"gcounter<int>://batch"}).receive(
+    [&](read_succeed_atom, const counter& y) { count = y.count(); },
+    [&](error&) { count = -1; }
+  );
+  CAF_CHECK(count == 101);
+  CAF_CHECK(metrics.deltas() - published == 1);
+}
+
 CAF_TEST_FIXTURE_SCOPE_END()
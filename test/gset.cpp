@@ -20,13 +20,19 @@
 #define CAF_SUITE gset
 #include "caf/test/unit_test.hpp"
 
+#include "caf/binary_serializer.hpp"
+#include "caf/binary_deserializer.hpp"
+
 #include "caf/crdt/all.hpp"
 
+using namespace caf;
+using namespace caf::crdt;
 using namespace caf::crdt::types;
 
+template <class Container = std::set<int>>
 void test_merge(const std::set<int>& lhs_, const std::set<int>& rhs_,
                 const std::set<int>& assumed_delta_) {
-  gset<int> lhs, rhs;
+  gset<int, Container> lhs, rhs;
   lhs.subset_insert(lhs_);
   rhs.subset_insert(rhs_);
   auto delta = lhs.merge(rhs);
@@ -35,9 +41,155 @@ void test_merge(const std::set<int>& lhs_, const std::set<int>& rhs_,
   CAF_CHECK(delta.size() == assumed_delta_.size());
 }
 
+template <class Container>
+void test_merge_all() {
+  test_merge<Container>({1,2,3,4}, {5,6,7,8}, {5,6,7,8});
+  test_merge<Container>({}, {5,6,7,8}, {5,6,7,8});
+  test_merge<Container>({1,2,3,4}, {}, {});
+  test_merge<Container>({1,2,3,4}, {1,2,5}, {5});
+}
+
+template <class Container>
+void test_includes() {
+  gset<int, Container> lhs, rhs;
+  lhs.subset_insert({1,2,3});
+  rhs.subset_insert({1,2,3,4});
+  CAF_CHECK(lhs.is_subset_of(rhs));
+  CAF_CHECK(!rhs.is_subset_of(lhs));
+  CAF_CHECK(rhs.is_superset_of(lhs));
+  CAF_CHECK(lhs.is_subset_of(std::set<int>{0,1,2,3}));
+  CAF_CHECK(!lhs.is_superset_of(std::set<int>{0,1}));
+  CAF_CHECK(lhs.equal({1,2,3}));
+  CAF_CHECK(lhs != rhs);
+  lhs.merge(rhs);
+  CAF_CHECK(lhs == rhs);
+  CAF_CHECK(std::set<int>(lhs.begin(), lhs.end()) == std::set<int>({1,2,3,4}));
+}
+
+template <class Container>
+void test_merge_full_state() {
+  // Interleaved states, every second element is missing on each side
+  std::set<int> evens;
+  std::set<int> odds;
+  for (int i = 0; i < 1000; ++i)
+    (i % 2 == 0 ? evens : odds).insert(i);
+  gset<int, Container> lhs, rhs;
+  lhs.subset_insert(evens);
+  rhs.subset_insert(odds);
+  auto delta = lhs.merge(rhs);
+  CAF_CHECK(lhs.size() == 1000);
+  CAF_CHECK(delta.equal(odds));
+  delta = lhs.merge(rhs);
+  CAF_CHECK(delta.empty());
+}
+
 CAF_TEST(merge) {
-  test_merge({1,2,3,4}, {5,6,7,8}, {5,6,7,8});
-  test_merge({}, {5,6,7,8}, {5,6,7,8});
-  test_merge({1,2,3,4}, {}, {});
-  test_merge({1,2,3,4}, {1,2,5}, {5});
+  test_merge_all<std::set<int>>();
+}
+
+CAF_TEST(merge_flat_set) {
+  test_merge_all<crdt::detail::flat_set<int>>();
+}
+
+CAF_TEST(merge_hash_set) {
+  test_merge_all<crdt::detail::hash_set<int>>();
+}
+
+CAF_TEST(merge_full_state) {
+  test_merge_full_state<std::set<int>>();
+  test_merge_full_state<crdt::detail::flat_set<int>>();
+  test_merge_full_state<crdt::detail::hash_set<int>>();
+}
+
+CAF_TEST(merge_roaring_set) {
+  test_merge_all<crdt::detail::roaring_set<int>>();
+  test_merge_full_state<crdt::detail::roaring_set<int>>();
+  // Dense blocks use bitmap containers, merges cross block boundaries
+  std::set<int> xs;
+  std::set<int> ys;
+  for (int i = -100000; i < 100000; ++i)
+    (i % 3 == 0 ? ys : xs).insert(i);
+  gset<int> lhs, rhs;
+  lhs.subset_insert(xs);
+  rhs.subset_insert(ys);
+  auto delta = lhs.merge(rhs);
+  CAF_CHECK(delta.equal(ys));
+  CAF_CHECK(lhs.size() == 200000);
+  CAF_CHECK(*lhs.begin() == -100000);
+  CAF_CHECK(lhs.merge(rhs).empty());
+}
+
+CAF_TEST(serialize_roaring_set) {
+  gset<int> xs;
+  std::set<int> elems;
+  for (int i = 0; i < 50000; ++i)
+    elems.insert(i < 40000 ? i : i * 7);
+  xs.subset_insert(elems);
+  std::vector<char> buf;
+  binary_serializer sink{nullptr, buf};
+  sink & xs;
+  // Runs compress the dense prefix far below 4 bytes per element
+  CAF_CHECK(buf.size() < elems.size());
+  // Serialization leaves the containers of its input untouched
+  std::vector<char> again;
+  binary_serializer again_sink{nullptr, again};
+  again_sink & xs;
+  CAF_CHECK(again == buf);
+  gset<int> ys;
+  binary_deserializer source{nullptr, buf};
+  source & ys;
+  CAF_CHECK(ys.equal(elems));
+  CAF_CHECK(xs == ys);
+}
+
+CAF_TEST(includes) {
+  test_includes<std::set<int>>();
+  test_includes<crdt::detail::flat_set<int>>();
+  test_includes<crdt::detail::hash_set<int>>();
+  test_includes<crdt::detail::roaring_set<int>>();
+}
+
+CAF_TEST(join_deltas) {
+  std::vector<message> deltas;
+  for (int i = 0; i < 10; ++i) {
+    gset<int> delta;
+    delta.subset_insert({i, i + 1});
+    deltas.emplace_back(make_message(std::move(delta)));
+  }
+  auto joined = crdt::detail::join_deltas<gset<int>>(deltas);
+  CAF_CHECK(joined.match_elements<gset<int>>());
+  CAF_CHECK(joined.get_as<gset<int>>(0).size() == 11);
+}
+
+CAF_TEST(digest) {
+  using crdt::detail::digest_range;
+  std::set<int> elems;
+  for (int i = 0; i < 10000; ++i)
+    elems.insert(i);
+  gset<int> lhs, rhs;
+  lhs.subset_insert(elems);
+  rhs.subset_insert(elems);
+  CAF_CHECK(crdt::detail::digest_root(lhs) == crdt::detail::digest_root(rhs));
+  lhs.insert(-1);
+  rhs.insert(-2);
+  // Both sides descend into differing ranges in turns until they are small
+  std::vector<digest_range> ranges{0};
+  std::vector<uint64_t> hashes{crdt::detail::digest_root(lhs)};
+  std::vector<digest_range> resolved;
+  auto turn = &rhs;
+  while (!ranges.empty()) {
+    auto step = crdt::detail::digest_compare(*turn, ranges, hashes);
+    resolved.insert(resolved.end(), step.resolved.begin(),
+                    step.resolved.end());
+    ranges = std::move(step.split);
+    hashes = std::move(step.hashes);
+    turn = turn == &rhs ? &lhs : &rhs;
+  }
+  CAF_CHECK(!resolved.empty() && resolved.size() <= 2);
+  // Only the elements of differing ranges are exchanged
+  auto part = crdt::detail::slice_of(lhs, resolved);
+  CAF_CHECK(part.size() <= 2 * (crdt::detail::digest_leaf_size + 1));
+  rhs.merge(part);
+  lhs.merge(crdt::detail::slice_of(rhs, resolved));
+  CAF_CHECK(lhs == rhs);
 }
@@ -0,0 +1,87 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#define CAF_SUITE lww_register
+#include "caf/test/unit_test.hpp"
+
+#include "caf/all.hpp"
+#include "caf/crdt/all.hpp"
+
+using namespace caf;
+using namespace caf::crdt;
+using namespace caf::crdt::types;
+
+namespace {
+
+class config : public crdt_config {};
+
+struct fixture {
+  fixture() : system{cfg} {
+    // nop
+  }
+
+  template <class Register>
+  void check_merge() {
+    auto dummy_actor = [](event_based_actor*) {};
+    Register lhs{system.spawn(dummy_actor)};
+    Register rhs{system.spawn(dummy_actor)};
+    CAF_CHECK(lhs.empty());
+    lhs.set(1);
+    rhs.set(2);
+    // Both replicas have to agree on one of the writes
+    auto delta1 = lhs.merge(rhs);
+    auto delta2 = rhs.merge(lhs);
+    CAF_CHECK(lhs.get() == rhs.get());
+    CAF_CHECK(delta1.empty() != delta2.empty());
+    // A later write wins
+    lhs.set(3);
+    auto delta = rhs.merge(lhs);
+    CAF_CHECK(rhs.get() == 3);
+    CAF_CHECK(!delta.empty());
+    delta = rhs.merge(lhs);
+    CAF_CHECK(delta.empty());
+  }
+
+  config cfg;
+  actor_system system;
+};
+
+} // namespace <anonymous>
+
+CAF_TEST_FIXTURE_SCOPE(lww_register_tests, fixture)
+
+CAF_TEST(merge_vector_clock) {
+  check_merge<lww_register<int>>();
+}
+
+CAF_TEST(merge_hybrid_logical_clock) {
+  check_merge<lww_register<int, hybrid_logical_clock>>();
+}
+
+CAF_TEST(hybrid_logical_clock_observe) {
+  hybrid_logical_clock clk;
+  clk.increment(system.node());
+  // A timestamp from a node with a clock far ahead
+  hybrid_logical_clock remote{clk.time() + (uint64_t{1} << 40), 0};
+  CAF_CHECK(clk.merge(remote).compare(remote) == equal);
+  clk.increment(system.node());
+  CAF_CHECK(clk.compare(remote) == greater);
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
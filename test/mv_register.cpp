@@ -70,4 +70,66 @@ CAF_TEST(merge) {
   CAF_CHECK(rhs.get_set().size() == 1 && rhs.get() == 5);
 }
 
+CAF_TEST(out_of_order) {
+  auto dummy_actor = [](event_based_actor*) {};
+  mv_register<int> lhs{system.spawn(dummy_actor)};
+  mv_register<int> rhs{system.spawn(dummy_actor)};
+  mv_register<int> observer{system.spawn(dummy_actor)};
+  lhs.set(1);
+  rhs.set(2);
+  // The later write of `rhs` must not hide the concurrent write of `lhs`
+  observer.merge(rhs);
+  observer.merge(lhs);
+  CAF_CHECK(observer.get_set().size() == 2);
+  lhs.merge(observer);
+  lhs.set(3);
+  observer.merge(lhs);
+  CAF_CHECK(observer.get_set().size() == 1 && observer.get() == 3);
+  auto delta = rhs.merge(observer);
+  CAF_CHECK(rhs.get() == 3);
+  CAF_CHECK(!delta.empty());
+  delta = rhs.merge(observer);
+  CAF_CHECK(delta.empty());
+}
+
+CAF_TEST(retired_writer) {
+  // A second system runs on another node, which is retired after its write
+  config other_cfg;
+  actor_system other{other_cfg};
+  auto dummy_actor = [](event_based_actor*) {};
+  mv_register<int> lhs{other.spawn(dummy_actor)};
+  mv_register<int> rhs{system.spawn(dummy_actor)};
+  lhs.set(1);
+  crdt::detail::slot_registry::instance().retire(other.node());
+  rhs.merge(lhs);
+  CAF_CHECK(rhs.get_set().size() == 1 && rhs.get() == 1);
+  // The context of the overwrite still covers the write of the retired node
+  rhs.set(2);
+  lhs.merge(rhs);
+  rhs.merge(lhs);
+  CAF_CHECK(lhs.get_set().size() == 1 && lhs.get() == 2);
+  CAF_CHECK(rhs.get_set().size() == 1 && rhs.get() == 2);
+}
+
+CAF_TEST(equal_roots) {
+  config other_cfg;
+  actor_system other{other_cfg};
+  auto dummy_actor = [](event_based_actor*) {};
+  mv_register<int> a{other.spawn(dummy_actor)};
+  mv_register<int> b{system.spawn(dummy_actor)};
+  a.set(1);
+  b.set(2);
+  // Equal states have equal roots regardless of the order of merges
+  mv_register<int> lhs;
+  mv_register<int> rhs;
+  lhs.merge(a);
+  lhs.merge(b);
+  rhs.merge(b);
+  rhs.merge(a);
+  CAF_CHECK(lhs.get_set().size() == 2);
+  CAF_CHECK(crdt::detail::digest_root(lhs) == crdt::detail::digest_root(rhs));
+  rhs.set(3);
+  CAF_CHECK(crdt::detail::digest_root(lhs) != crdt::detail::digest_root(rhs));
+}
+
 CAF_TEST_FIXTURE_SCOPE_END()
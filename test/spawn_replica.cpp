@@ -23,6 +23,8 @@
 #include "caf/all.hpp"
 #include "caf/crdt/all.hpp"
 
+#include <thread>
+
 using namespace caf;
 using namespace caf::crdt;
 using namespace caf::crdt::types;
@@ -47,6 +49,68 @@ struct fixture {
   actor_system system;
 };
 
+class sharded_config : public config {
+public:
+  sharded_config() {
+    set_replicator_shards(4);
+  }
+};
+
+struct sharded_fixture {
+  sharded_fixture() : system{cfg} {
+    // nop
+  }
+
+  sharded_config cfg;
+  actor_system system;
+};
+
+class flush_config : public config {
+public:
+  flush_config() {
+    set_flush_max_deltas(2);
+  }
+};
+
+struct flush_fixture {
+  flush_fixture() : system{cfg} {
+    // nop
+  }
+
+  flush_config cfg;
+  actor_system system;
+};
+
+class notify_config : public config {
+public:
+  notify_config() {
+    set_notify_interval(milliseconds(500));
+    set_notify_interval_bounds(milliseconds(10), milliseconds(1000));
+  }
+};
+
+struct notify_fixture {
+  notify_fixture() : system{cfg} {
+    // nop
+  }
+
+  notify_config cfg;
+  actor_system system;
+};
+
+bool subscribe(actor_system& system, const std::string& id) {
+  auto repl = system.replicator().actor_handle();
+  scoped_actor self{system};
+  bool failed = false;
+  self->request(repl, seconds(1), subscribe_atom::value, uri{id}).receive(
+    [] {
+      // nop
+    },
+    [&](error&) { failed = true; }
+  );
+  return !failed;
+}
+
 } // namespace <anonymous>
 
 
@@ -81,3 +145,43 @@ CAF_TEST(spawn_ok) {
 }
 
 CAF_TEST_FIXTURE_SCOPE_END()
+
+CAF_TEST_FIXTURE_SCOPE(sharded_spawn_replica_test, sharded_fixture)
+
+CAF_TEST(sharded_spawn) {
+  CAF_CHECK(!subscribe(system, "gset<int>://bla"));
+  for (int i = 0; i < 16; ++i)
+    CAF_CHECK(subscribe(system, "gset<float>://bla" + std::to_string(i)));
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
+
+CAF_TEST_FIXTURE_SCOPE(flush_test, flush_fixture)
+
+CAF_TEST(flush_on_size) {
+  scoped_actor self{system};
+  gset<float> xs{actor_cast<actor>(self), "gset<float>://flush"};
+  xs.insert(1.f);
+  xs.insert(2.f);
+  auto& metrics = system.replicator().metrics();
+  for (int i = 0; i < 100 && metrics.flushes(flush_trigger::size) == 0; ++i)
+    std::this_thread::sleep_for(milliseconds(10));
+  CAF_CHECK(metrics.flushes(flush_trigger::size) == 1);
+  CAF_CHECK(metrics.deltas() == 2);
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
+
+CAF_TEST_FIXTURE_SCOPE(notify_test, notify_fixture)
+
+CAF_TEST(notify_interval_metric) {
+  CAF_REQUIRE(subscribe(system, "gset<float>://notify"));
+  auto& intervals = system.replicator().notify_intervals();
+  uri id{"gset<float>://notify"};
+  for (int i = 0; i < 100 && intervals.interval(id) == 0; ++i)
+    std::this_thread::sleep_for(milliseconds(10));
+  // Starts with the notify interval, which is within the bounds
+  CAF_CHECK_EQUAL(intervals.interval(id), 500u);
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
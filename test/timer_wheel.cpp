@@ -0,0 +1,86 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+
+#define CAF_SUITE timer_wheel
+#include "caf/test/unit_test.hpp"
+
+#include "caf/all.hpp"
+
+#include "caf/crdt/detail/timer_wheel.hpp"
+
+#include <vector>
+
+using namespace caf;
+
+namespace {
+
+struct fixture {
+  fixture() : system{cfg}, self{system} {
+    // nop
+  }
+
+  /// Advances `wheel` to `to` and returns the number of expired timers
+  size_t advance(crdt::detail::timer_wheel& wheel, uint64_t to) {
+    size_t result = 0;
+    wheel.advance(to, [&](actor&) { ++result; });
+    return result;
+  }
+
+  actor_system_config cfg;
+  actor_system system;
+  scoped_actor self;
+};
+
+} // namespace <anonymous>
+
+CAF_TEST_FIXTURE_SCOPE(timer_wheel_tests, fixture)
+
+CAF_TEST(expire_in_order) {
+  crdt::detail::timer_wheel wheel;
+  auto hdl = actor_cast<actor>(self);
+  // One timer per level up to 64^3 ticks
+  std::vector<uint64_t> delays{0, 1, 63, 64, 65, 4095, 4096, 300000};
+  for (auto delay : delays)
+    wheel.schedule(delay, hdl);
+  CAF_CHECK_EQUAL(wheel.size(), delays.size());
+  CAF_CHECK_EQUAL(wheel.next_expiry(), 1u);
+  CAF_CHECK_EQUAL(advance(wheel, 1), 2u); // Delays are at least one tick
+  CAF_CHECK_EQUAL(advance(wheel, 62), 0u);
+  CAF_CHECK_EQUAL(advance(wheel, 63), 1u);
+  CAF_CHECK_EQUAL(advance(wheel, 65), 2u);
+  CAF_CHECK_EQUAL(advance(wheel, 4095), 1u);
+  CAF_CHECK_EQUAL(advance(wheel, 299999), 1u);
+  CAF_CHECK_EQUAL(wheel.size(), 1u);
+  CAF_CHECK(wheel.now() + wheel.next_expiry() <= 300000);
+  CAF_CHECK_EQUAL(advance(wheel, 300000), 1u);
+  CAF_CHECK(wheel.empty());
+  CAF_CHECK_EQUAL(wheel.next_expiry(), crdt::detail::timer_wheel::never);
+}
+
+CAF_TEST(schedule_relative_to_now) {
+  crdt::detail::timer_wheel wheel;
+  auto hdl = actor_cast<actor>(self);
+  advance(wheel, 1000);
+  wheel.schedule(10, hdl);
+  CAF_CHECK_EQUAL(advance(wheel, 1009), 0u);
+  CAF_CHECK_EQUAL(advance(wheel, 1010), 1u);
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
@@ -24,6 +24,9 @@
 
 #include "caf/crdt/uri.hpp"
 
+#include "caf/crdt/detail/hash_ring.hpp"
+#include "caf/crdt/detail/uri_registry.hpp"
+
 using namespace caf;
 using namespace caf::crdt;
 
@@ -42,3 +45,48 @@ CAF_TEST(uri_parse) {
   for (auto& what : valid) CAF_CHECK(uri{what}.valid());
   for (auto& what : invalid) CAF_CHECK(!uri{what}.valid());
 }
+
+CAF_TEST(uri_intern) {
+  auto& reg = crdt::detail::uri_registry::instance();
+  uri x{"gset<int>://videos"};
+  uri y{"gset<int>://views"};
+  auto id = reg.intern(x);
+  CAF_CHECK(reg.intern(x) == id);
+  CAF_CHECK(reg.intern(y) != id);
+  CAF_CHECK(reg.get(id) == x);
+}
+
+CAF_TEST(uri_order) {
+  uri x{"GSet<int>://Videos/*ignored"};
+  CAF_CHECK_EQUAL(x.scheme(), "gset<int>");
+  CAF_CHECK_EQUAL(x.path(), "/videos/*");
+  CAF_CHECK_EQUAL(x.to_string(), "gset<int>://videos/*");
+  CAF_CHECK(x == uri{"gset<int>://videos/*"});
+  uri lhs{"gset<int>://a"};
+  uri rhs{"gset<int>://b"};
+  CAF_CHECK(lhs < rhs);
+  CAF_CHECK(!(rhs < lhs));
+  CAF_CHECK(lhs != rhs);
+  CAF_CHECK_EQUAL(std::hash<uri>{}(lhs), lhs.hash());
+}
+
+CAF_TEST(hash_ring) {
+  node_id a{1, "0123456789012345678901234567890123456789"};
+  node_id b{2, "0123456789012345678901234567890123456789"};
+  node_id c{3, "0123456789012345678901234567890123456789"};
+  crdt::detail::hash_ring ring{16};
+  ring.add(a);
+  ring.add(b);
+  uri x{"gset<int>://videos"};
+  auto owners = ring.owners(x, 3);
+  CAF_CHECK_EQUAL(owners.size(), 2u);
+  CAF_CHECK(ring.owns(a, x, 2) && ring.owns(b, x, 2));
+  // Adding a node moves only uris which the new node owns
+  auto before = ring.owners(x, 1);
+  ring.add(c);
+  auto after = ring.owners(x, 1);
+  CAF_CHECK(after == before || after.front() == c);
+  ring.remove(c);
+  CAF_CHECK(ring.owners(x, 1) == before);
+  CAF_CHECK(!ring.contains(c));
+}
@@ -23,6 +23,10 @@
 #include "caf/all.hpp"
 #include "caf/crdt/all.hpp"
 
+#include "caf/crdt/detail/clock_kernels.hpp"
+
+#include <limits>
+
 using namespace caf;
 using namespace caf::crdt;
 using namespace caf::crdt::types;
@@ -103,4 +107,111 @@ CAF_TEST(test_simultaneous) {
   }
 }
 
+/// Test node slots shared by all actors of a node
+CAF_TEST(test_node_slots) {
+  vector_clock clk1;
+  vector_clock clk2;
+  clk1.increment(system.node(), "scope");
+  clk2.increment(system.node(), "scope");
+  CAF_CHECK(clk1.count() == 1);
+  CAF_CHECK(clk1.compare(clk2) == smaller);
+  clk1.merge(clk2);
+  clk1.increment(system.node(), "scope");
+  CAF_CHECK(clk1.get(system.node()) == 3);
+  CAF_CHECK(clk1.count() == 1);
+  CAF_CHECK(clk1.compare(clk2) == greater);
+}
+
+/// Test merge and returned delta
+CAF_TEST(test_merge) {
+  auto dummy1 = system.spawn([](event_based_actor*) {});
+  auto dummy2 = system.spawn([](event_based_actor*) {});
+  auto dummy3 = system.spawn([](event_based_actor*) {});
+  vector_clock clk1;
+  vector_clock clk2;
+  clk1.increment(dummy1);
+  clk1.increment(dummy2);
+  clk2.increment(dummy2);
+  clk2.increment(dummy2);
+  clk2.increment(dummy3);
+  auto delta = clk1.merge(clk2);
+  CAF_CHECK(clk1.get(dummy1) == 1);
+  CAF_CHECK(clk1.get(dummy2) == 2);
+  CAF_CHECK(clk1.get(dummy3) == 1);
+  CAF_CHECK(clk1.count() == 3);
+  CAF_CHECK(clk1.compare(clk2) == greater);
+  CAF_CHECK(delta.get(dummy2) == 2);
+  CAF_CHECK(delta.get(dummy3) == 1);
+  delta = clk1.merge(clk1);
+  CAF_CHECK(delta.count() == 0);
+}
+
+/// Test serialization roundtrip
+CAF_TEST(test_serialize) {
+  auto dummy1 = system.spawn([](event_based_actor*) {});
+  auto dummy2 = system.spawn([](event_based_actor*) {});
+  vector_clock clk1;
+  clk1.increment(dummy1);
+  clk1.increment(dummy2);
+  clk1.increment(dummy2);
+  std::vector<char> buf;
+  binary_serializer sink{system, buf};
+  sink & clk1;
+  vector_clock clk2;
+  binary_deserializer source{system, buf};
+  source & clk2;
+  CAF_CHECK(clk1.compare(clk2) == equal);
+  CAF_CHECK(clk2.get(dummy2) == 2);
+}
+
+/// Test dropping slots of retired nodes
+CAF_TEST(test_compact) {
+  // Retiring is process-wide, use a node no other test refers to
+  node_id lost{42, "0123456789012345678901234567890123456789"};
+  vector_clock clk1;
+  vector_clock clk2;
+  clk1.increment(system.node(), "compact");
+  clk1.increment(lost, "compact");
+  clk2.increment(lost, "compact");
+  clk2.increment(lost, "compact");
+  CAF_CHECK(clk1.count() == 2);
+  crdt::detail::slot_registry::instance().retire(lost);
+  auto delta = clk1.merge(clk2);
+  CAF_CHECK(clk1.count() == 1);
+  CAF_CHECK(clk1.get(lost) == 0);
+  CAF_CHECK(delta.count() == 0);
+  CAF_CHECK(clk2.compact());
+  CAF_CHECK(!clk2.compact());
+  CAF_CHECK(clk1.compare(clk2) == greater);
+}
+
+/// Test vector kernels against the scalar fallback
+CAF_TEST(test_kernels) {
+  using caf::crdt::detail::clock_kernels;
+  auto& simd = clock_kernels::instance();
+  auto& scalar = clock_kernels::scalar();
+  for (size_t n = 0; n < 67; ++n) {
+    std::vector<uint64_t> lhs(n);
+    std::vector<uint64_t> rhs(n);
+    for (size_t i = 0; i < n; ++i) {
+      lhs[i] = (i * 7) % 5;
+      rhs[i] = (i * 3) % 5;
+    }
+    // Values with the highest bit set must still compare unsigned
+    if (n > 0)
+      lhs[n - 1] = std::numeric_limits<uint64_t>::max();
+    bool g1 = false, s1 = false, g2 = false, s2 = false;
+    simd.dominance(lhs.data(), rhs.data(), n, g1, s1);
+    scalar.dominance(lhs.data(), rhs.data(), n, g2, s2);
+    CAF_CHECK(g1 == g2);
+    CAF_CHECK(s1 == s2);
+    CAF_CHECK(simd.count_differ(lhs.data(), rhs.data(), n)
+              == scalar.count_differ(lhs.data(), rhs.data(), n));
+    auto joined = lhs;
+    simd.join(joined.data(), rhs.data(), n);
+    scalar.join(lhs.data(), rhs.data(), n);
+    CAF_CHECK(joined == lhs);
+  }
+}
+
 CAF_TEST_FIXTURE_SCOPE_END()